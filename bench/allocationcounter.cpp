@@ -0,0 +1,52 @@
+#include "allocationcounter.hpp"
+
+#include <atomic>
+#include <new>
+
+#include <cstdlib>
+
+
+/** Number of heap allocations */
+static std::atomic<std::size_t> allocations(0U);
+
+
+// Static methods
+
+// Get the number of heap allocations since the start
+std::size_t AllocationCounter::getAllocations() {
+    return allocations.load();
+}
+
+// Count a heap allocation
+void AllocationCounter::count() {
+    allocations++;
+}
+
+
+// Replaced global operators
+
+/** Counted allocation */
+void *operator new(std::size_t size) {
+    AllocationCounter::count();
+    void *const memory = std::malloc(size == 0U ? 1U : size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return memory;
+}
+
+/** Counted array allocation */
+void *operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+/** Deallocation */
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+/** Array deallocation */
+void operator delete[](void *memory) noexcept {
+    std::free(memory);
+}
\ No newline at end of file
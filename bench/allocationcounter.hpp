@@ -0,0 +1,26 @@
+#ifndef __ALLOCATION_COUNTER_HPP_
+#define __ALLOCATION_COUNTER_HPP_
+
+#include <cstddef>
+
+
+/** Heap allocations counter through the replaced global new operators */
+class AllocationCounter {
+    private:
+        // Constructors
+
+        /** Disable the default constructor */
+        AllocationCounter() = delete;
+
+
+    public:
+        // Static methods
+
+        /** Get the number of heap allocations since the start */
+        static std::size_t getAllocations();
+
+        /** Count a heap allocation */
+        static void count();
+};
+
+#endif // __ALLOCATION_COUNTER_HPP_
\ No newline at end of file
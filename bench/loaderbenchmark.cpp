@@ -0,0 +1,89 @@
+#include "loaderbenchmark.hpp"
+#include "allocationcounter.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <vector>
+
+#include <cmath>
+#include <iostream>
+
+
+// Private methods
+
+// Delete the current loader and its data and create a new one
+void LoaderBenchmark::reset() {
+    if (loader != nullptr) {
+        delete loader->model_data;
+        delete loader;
+    }
+
+    loader = new OBJLoader(path);
+}
+
+// Fill the loader stocks with the generated attributes
+void LoaderBenchmark::fillStocks() {
+    loader->position_stock = generator.getPositions();
+    loader->uv_coord_stock = generator.getUVCoords();
+    loader->normal_stock   = generator.getNormals();
+}
+
+
+// Constructor
+
+// Loader benchmark constructor
+LoaderBenchmark::LoaderBenchmark(const std::string &path, const OBJGenerator &generator) :
+    path(path),
+    generator(generator),
+    loader(nullptr) {}
+
+
+// Methods
+
+// Run the loader kernels
+void LoaderBenchmark::run(MicroBenchmark &bench) {
+    // Tokenize and parse the whole synthetic file
+    bench.run("obj_read", [this] () { reset(); }, [this] () {
+        loader->read();
+    });
+
+    // Report the heap and arena allocations of a single read
+    reset();
+    const std::size_t allocations = AllocationCounter::getAllocations();
+    loader->read();
+    std::cout << "obj_read allocations: " << AllocationCounter::getAllocations() - allocations << " heap, " << loader->arena.getAllocations() << " arena in " << loader->arena.getBlocks() << " blocks (" << loader->arena.getBytes() << " bytes)" << std::endl;
+
+    // Deduplicate the face vertices
+    bench.run("store_vertex", [this] () { reset(); fillStocks(); }, [this] () {
+        for (const std::string &vertex : generator.getFaceVertices()) {
+            loader->storeVertex(vertex.c_str(), vertex.size());
+        }
+    });
+
+    // Accumulate and orthogonalize the tangents of the deduplicated vertices left by the previous kernel
+    std::vector<glm::vec3> tangent;
+    bench.run("calc_tangents", [] () {}, [&tangent, this] () {
+        OBJLoader::calcTangents(loader->vertex_stock, loader->index_stock, tangent);
+    });
+
+    // Compute the bounding box of the positions
+    bench.run("aabb", [this] () {
+        loader->model_data->min = glm::vec3(INFINITY);
+        loader->model_data->max = glm::vec3(-INFINITY);
+    }, [this] () {
+        for (const glm::vec3 &position : loader->position_stock) {
+            loader->updateLimits(position);
+        }
+    });
+}
+
+
+// Destructor
+
+// Loader benchmark destructor
+LoaderBenchmark::~LoaderBenchmark() {
+    if (loader != nullptr) {
+        delete loader->model_data;
+        delete loader;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef __LOADER_BENCHMARK_HPP_
+#define __LOADER_BENCHMARK_HPP_
+
+#include "microbenchmark.hpp"
+#include "objgenerator.hpp"
+
+#include "../src/model/loader/objloader.hpp"
+
+#include <string>
+
+
+/** Microbenchmarks of the OBJ loader kernels */
+class LoaderBenchmark {
+    private:
+        // Attributes
+
+        /** Synthetic model path */
+        const std::string path;
+
+        /** Synthetic model generator */
+        const OBJGenerator &generator;
+
+        /** Loader under measure */
+        OBJLoader *loader;
+
+
+        // Constructors
+
+        /** Disable the default constructor */
+        LoaderBenchmark() = delete;
+
+        /** Disable the default copy constructor */
+        LoaderBenchmark(const LoaderBenchmark &) = delete;
+
+        /** Disable the assignation operator */
+        LoaderBenchmark &operator=(const LoaderBenchmark &) = delete;
+
+
+        // Methods
+
+        /** Delete the current loader and its data and create a new one */
+        void reset();
+
+        /** Fill the loader stocks with the generated attributes */
+        void fillStocks();
+
+
+    public:
+        // Constructor
+
+        /** Loader benchmark constructor */
+        LoaderBenchmark(const std::string &path, const OBJGenerator &generator);
+
+
+        // Methods
+
+        /** Run the loader kernels */
+        void run(MicroBenchmark &bench);
+
+
+        // Destructor
+
+        /** Loader benchmark destructor */
+        virtual ~LoaderBenchmark();
+};
+
+#endif // __LOADER_BENCHMARK_HPP_
\ No newline at end of file
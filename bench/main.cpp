@@ -0,0 +1,149 @@
+#include "microbenchmark.hpp"
+#include "objgenerator.hpp"
+#include "loaderbenchmark.hpp"
+
+#include "../src/scene/scene.hpp"
+#include "../src/scene/glslprogram.hpp"
+#include "../src/model/stb/stb_image.h"
+#include "../src/dirsep.h"
+
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include <cstdlib>
+
+
+/** Decode an image file from memory with and without the vertical flip */
+static void imageBenchmarks(MicroBenchmark &bench, const std::string &name, const std::string &path) {
+    // Read the encoded file
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "warning: skipping the `" << name << "' image benchmarks, could not open `" << path << "'" << std::endl;
+        return;
+    }
+    const std::vector<stbi_uc> encoded((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // Decode as the material textures are loaded
+    for (const int &flip : {0, 1}) {
+        bench.run(name + (flip == 1 ? "_decode_flip" : "_decode"), [flip] () { stbi_set_flip_vertically_on_load(flip); }, [&encoded] () {
+            int width;
+            int height;
+            int channels;
+            stbi_image_free(stbi_load_from_memory(encoded.data(), static_cast<int>(encoded.size()), &width, &height, &channels, STBI_rgb_alpha));
+        });
+    }
+}
+
+/** Set the uniforms of a model draw through the program location stock */
+static void uniformBenchmarks(MicroBenchmark &bench, const std::string &shader_path) {
+    // Link the normal mapping program
+    GLSLProgram program(shader_path + "gp_normal.vert.glsl", shader_path + "gp_normal.frag.glsl");
+    if (!program.isValid()) {
+        std::cerr << "warning: skipping the uniform benchmarks, could not link the program" << std::endl;
+        return;
+    }
+
+    // Set the per model and per material uniforms of a thousand draws
+    const glm::mat4 matrix(1.0F);
+    const glm::mat3 normal_matrix(1.0F);
+    const glm::vec3 color(0.5F);
+    bench.run("uniform_lookup", [&program] () { program.use(); }, [&] () {
+        for (int i = 0; i < 1000; i++) {
+            program.setUniform("u_model_mat", matrix);
+            program.setUniform("u_normal_mat", normal_matrix);
+            program.setUniform("u_compact", 0);
+            program.setUniform("u_lod_bias", 0.0F);
+            program.setUniform("u_ambient", color);
+            program.setUniform("u_diffuse", color);
+            program.setUniform("u_specular", color);
+            program.setUniform("u_shininess", 64.0F);
+        }
+    });
+}
+
+
+/** Benchmarks main function */
+int main(int argc, char **argv) {
+    // Parse the options
+    std::string output = "bench_results.json";
+    std::string baseline;
+    int size = 256;
+    int repetitions = 15;
+    double tolerance = 0.10;
+    for (int i = 1; i < argc - 1; i++) {
+        const std::string option = argv[i];
+        if (option == "--output") {
+            output = argv[++i];
+        }
+        else if (option == "--baseline") {
+            baseline = argv[++i];
+        }
+        else if (option == "--size") {
+            size = std::atoi(argv[++i]);
+        }
+        else if (option == "--repetitions") {
+            repetitions = std::atoi(argv[++i]);
+        }
+        else if (option == "--tolerance") {
+            tolerance = std::atof(argv[++i]);
+        }
+    }
+
+    // Setup directories
+    const std::string bin_path = argv[0];
+    const std::string relative = bin_path.substr(0U, bin_path.find_last_of(DIR_SEP) + 1U);
+
+    const std::string model_path  = relative + ".." + DIR_SEP + "model"  + DIR_SEP;
+    const std::string shader_path = relative + ".." + DIR_SEP + "shader" + DIR_SEP;
+
+
+    // The programs need a context, use a headless one and skip their kernels without it
+    Scene *scene = new Scene("OBJViewer microbenchmarks", 64, 64, 3, 3, true);
+    const bool context = scene->isValid();
+    if (!context) {
+        std::cerr << "warning: skipping the OpenGL benchmarks, could not create a headless context" << std::endl;
+    }
+
+    // Generate the synthetic model
+    const OBJGenerator generator(size);
+    const std::string synthetic_path = output.substr(0U, output.find_last_of(DIR_SEP) + 1U) + "synthetic.obj";
+    if (!generator.write(synthetic_path)) {
+        delete scene;
+        return 1;
+    }
+    std::cout << "benchmark: " << size << "x" << size << " synthetic grid, " << generator.getFaceVertices().size() / 3U << " triangles, " << repetitions << " repetitions" << std::endl;
+
+
+    // Run the kernels
+    MicroBenchmark bench(repetitions);
+    {
+        LoaderBenchmark loader(synthetic_path, generator);
+        loader.run(bench);
+    }
+    imageBenchmarks(bench, "jpeg", model_path + "box" + DIR_SEP + "bricks.jpg");
+    imageBenchmarks(bench, "png",  model_path + "box" + DIR_SEP + "door_normal.png");
+    if (context) {
+        uniformBenchmarks(bench, shader_path);
+    }
+
+    // Clean up the context
+    delete scene;
+
+
+    // Write the results and compare them against the baseline
+    if (!bench.write(output)) {
+        return 1;
+    }
+
+    if (!baseline.empty() && !bench.compare(baseline, tolerance)) {
+        std::cerr << "error: performance regression over " << tolerance * 100.0 << "% against `" << baseline << "'" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
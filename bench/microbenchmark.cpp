@@ -0,0 +1,166 @@
+#include "microbenchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+
+// Private static methods
+
+// Get the time in milliseconds of a monotonic clock
+double MicroBenchmark::now() {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+// Constructor
+
+// Micro benchmark constructor
+MicroBenchmark::MicroBenchmark(const int &repetitions, const int &warmup) :
+    repetitions(std::max(repetitions, 1)),
+    warmup(std::max(warmup, 0)) {}
+
+
+// Getters
+
+// Get the results
+const std::map<std::string, MicroBenchmark::Result> &MicroBenchmark::getResults() const {
+    return result;
+}
+
+
+// Methods
+
+// Run the kernel after the untimed setup of each repetition
+void MicroBenchmark::run(const std::string &name, const std::function<void ()> &setup, const std::function<void ()> &kernel) {
+    // Warm up the caches and allocator
+    for (int i = 0; i < warmup; i++) {
+        setup();
+        kernel();
+    }
+
+    // Measure each repetition
+    std::vector<double> time(static_cast<std::size_t>(repetitions));
+    for (double &sample : time) {
+        setup();
+        const double start = MicroBenchmark::now();
+        kernel();
+        sample = MicroBenchmark::now() - start;
+    }
+
+    // Compute the statistics
+    std::sort(time.begin(), time.end());
+    MicroBenchmark::Result stats;
+    const std::size_t middle = time.size() / 2U;
+    stats.median = (time.size() % 2U) == 1U ? time[middle] : (time[middle - 1U] + time[middle]) / 2.0;
+    stats.mean   = std::accumulate(time.begin(), time.end(), 0.0) / static_cast<double>(time.size());
+    stats.min    = time.front();
+    stats.stddev = 0.0;
+    for (const double &sample : time) {
+        stats.stddev += (sample - stats.mean) * (sample - stats.mean);
+    }
+    stats.stddev      = std::sqrt(stats.stddev / static_cast<double>(time.size()));
+    stats.repetitions = repetitions;
+
+    // Store and report the result
+    this->name.push_back(name);
+    result[name] = stats;
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(3)
+              << " median " << std::setw(10) << stats.median << "ms"
+              << "  mean "  << std::setw(10) << stats.mean   << "ms"
+              << "  min "   << std::setw(10) << stats.min    << "ms"
+              << "  sd "    << std::setw(8)  << stats.stddev << "ms" << std::endl;
+}
+
+// Write the results to a JSON file
+bool MicroBenchmark::write(const std::string &path) const {
+    // Open the results file
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "error: could not open the benchmark results file `" << path << "'" << std::endl;
+        return false;
+    }
+
+    // One benchmark per line to keep the baseline diffs readable
+    file << "{" << std::endl;
+    for (std::size_t i = 0U; i < name.size(); i++) {
+        const MicroBenchmark::Result &stats = result.at(name[i]);
+        file << "  \"" << name[i] << "\": {\"median_ms\": " << stats.median << ", \"mean_ms\": " << stats.mean << ", \"min_ms\": " << stats.min << ", \"stddev_ms\": " << stats.stddev << ", \"repetitions\": " << stats.repetitions << "}" << (i + 1U < name.size() ? "," : "") << std::endl;
+    }
+    file << "}" << std::endl;
+
+    std::cout << "benchmark: results written to `" << path << "'" << std::endl;
+    return true;
+}
+
+// Compare the medians against a baseline JSON file, false if any regression exceeds the tolerance
+bool MicroBenchmark::compare(const std::string &path, const double &tolerance) const {
+    // Read the baseline
+    std::map<std::string, double> baseline;
+    if (!MicroBenchmark::read(path, baseline)) {
+        return false;
+    }
+
+    // Compare each benchmark present in both
+    bool status = true;
+    for (const std::string &current : name) {
+        const std::map<std::string, double>::const_iterator reference = baseline.find(current);
+        if (reference == baseline.end()) {
+            std::cout << "baseline: " << current << " is new" << std::endl;
+            continue;
+        }
+
+        // Skip the baseline medians that can not scale the change, below the timer resolution or edited
+        if (!(reference->second > 0.0)) {
+            std::cerr << "warning: the baseline median of " << current << " is not positive, skipping it" << std::endl;
+            continue;
+        }
+
+        // Relative change of the median
+        const double change = (result.at(current).median - reference->second) / reference->second;
+        if (change > tolerance) {
+            std::cerr << "REGRESSION: " << current << " " << std::fixed << std::setprecision(1) << change * 100.0 << "% slower than the baseline (" << std::setprecision(3) << reference->second << "ms -> " << result.at(current).median << "ms)" << std::endl;
+            status = false;
+        }
+        else {
+            std::cout << "baseline: " << current << " " << std::showpos << std::fixed << std::setprecision(1) << change * 100.0 << std::noshowpos << "%" << std::endl;
+        }
+    }
+
+    return status;
+}
+
+
+// Static methods
+
+// Read the medians of a JSON results file
+bool MicroBenchmark::read(const std::string &path, std::map<std::string, double> &median) {
+    // Open the results file
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "error: could not open the benchmark baseline file `" << path << "'" << std::endl;
+        return false;
+    }
+
+    // Read the benchmark name and median of each line
+    const std::string key = "\"median_ms\":";
+    std::string line;
+    while (std::getline(file, line)) {
+        const std::size_t begin = line.find('"');
+        const std::size_t end   = line.find('"', begin + 1U);
+        const std::size_t value = line.find(key);
+        if ((begin == std::string::npos) || (end == std::string::npos) || (value == std::string::npos)) {
+            continue;
+        }
+
+        median[line.substr(begin + 1U, end - begin - 1U)] = std::atof(line.c_str() + value + key.size());
+    }
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#ifndef __MICRO_BENCHMARK_HPP_
+#define __MICRO_BENCHMARK_HPP_
+
+#include <functional>
+#include <string>
+
+#include <map>
+#include <vector>
+
+
+/** Repeated CPU kernel timing with baseline comparison */
+class MicroBenchmark {
+    public:
+        // Structs
+
+        /** Benchmark result in milliseconds */
+        struct Result {
+            /** Median time */
+            double median;
+
+            /** Mean time */
+            double mean;
+
+            /** Minimum time */
+            double min;
+
+            /** Standard deviation */
+            double stddev;
+
+            /** Number of repetitions */
+            int repetitions;
+        };
+
+
+    private:
+        // Attributes
+
+        /** Measured repetitions */
+        int repetitions;
+
+        /** Warm up repetitions */
+        int warmup;
+
+        /** Names in registration order */
+        std::vector<std::string> name;
+
+        /** Results by name */
+        std::map<std::string, MicroBenchmark::Result> result;
+
+
+        // Static methods
+
+        /** Get the time in milliseconds of a monotonic clock */
+        static double now();
+
+
+    public:
+        // Constructor
+
+        /** Micro benchmark constructor */
+        MicroBenchmark(const int &repetitions = 15, const int &warmup = 2);
+
+
+        // Getters
+
+        /** Get the results */
+        const std::map<std::string, MicroBenchmark::Result> &getResults() const;
+
+
+        // Methods
+
+        /** Run the kernel after the untimed setup of each repetition */
+        void run(const std::string &name, const std::function<void ()> &setup, const std::function<void ()> &kernel);
+
+        /** Write the results to a JSON file */
+        bool write(const std::string &path) const;
+
+        /** Compare the medians against a baseline JSON file, false if any regression exceeds the tolerance */
+        bool compare(const std::string &path, const double &tolerance) const;
+
+
+        // Static methods
+
+        /** Read the medians of a JSON results file */
+        static bool read(const std::string &path, std::map<std::string, double> &median);
+};
+
+#endif // __MICRO_BENCHMARK_HPP_
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "objgenerator.hpp"
+
+#include "../src/dirsep.h"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+
+// Constructor
+
+// Generate a wavy grid with the given quads per side and materials
+OBJGenerator::OBJGenerator(const int &size, const int &materials) :
+    size(std::max(size, 1)),
+    materials(std::max(materials, 1)) {
+    // Grid vertices with a wave to get non trivial normals and tangents
+    const float step = 1.0F / static_cast<float>(this->size);
+    for (int z = 0; z <= this->size; z++) {
+        for (int x = 0; x <= this->size; x++) {
+            const float s = static_cast<float>(x) * step;
+            const float t = static_cast<float>(z) * step;
+            const float height = 0.05F * std::sin(s * 12.0F) * std::cos(t * 12.0F);
+            position.push_back(glm::vec3(s - 0.5F, height, t - 0.5F));
+            uv_coord.push_back(glm::vec2(s, t));
+            normal.push_back(glm::normalize(glm::vec3(-0.6F * std::cos(s * 12.0F) * std::cos(t * 12.0F), 1.0F, 0.6F * std::sin(s * 12.0F) * std::sin(t * 12.0F))));
+        }
+    }
+
+    // Triangulate the quads as the loader does, first, previous and current vertex
+    for (int z = 0; z < this->size; z++) {
+        for (int x = 0; x < this->size; x++) {
+            const int a = z * (this->size + 1) + x + 1;
+            const int quad[4] = {a, a + 1, a + this->size + 2, a + this->size + 1};
+            for (int i = 2; i < 4; i++) {
+                for (const int &index : {quad[0], quad[i - 1], quad[i]}) {
+                    const std::string id = std::to_string(index);
+                    face_vertex.push_back(id + "/" + id + "/" + id);
+                }
+            }
+        }
+    }
+}
+
+
+// Getters
+
+// Get the positions
+const std::vector<glm::vec3> &OBJGenerator::getPositions() const {
+    return position;
+}
+
+// Get the texture coordinates
+const std::vector<glm::vec2> &OBJGenerator::getUVCoords() const {
+    return uv_coord;
+}
+
+// Get the normals
+const std::vector<glm::vec3> &OBJGenerator::getNormals() const {
+    return normal;
+}
+
+// Get the triangulated face vertices
+const std::vector<std::string> &OBJGenerator::getFaceVertices() const {
+    return face_vertex;
+}
+
+
+// Methods
+
+// Write the OBJ file and its MTL file next to it
+bool OBJGenerator::write(const std::string &path) const {
+    // Material file path and name
+    const std::string mtl_path = path.substr(0U, path.find_last_of('.')) + ".mtl";
+    const std::string mtl_name = mtl_path.substr(mtl_path.find_last_of(DIR_SEP) + 1U);
+
+    // Open the files
+    std::ofstream obj(path);
+    std::ofstream mtl(mtl_path);
+    if (!obj.is_open() || !mtl.is_open()) {
+        std::cerr << "error: could not write the synthetic model `" << path << "'" << std::endl;
+        return false;
+    }
+
+    // Materials without textures, the kernels must not depend on the image decoder
+    for (int i = 0; i < materials; i++) {
+        const float shade = static_cast<float>(i + 1) / static_cast<float>(materials);
+        mtl << "newmtl material_" << i << std::endl;
+        mtl << "Ka 0.0 0.0 0.0" << std::endl;
+        mtl << "Kd " << shade << " 0.5 " << 1.0F - shade << std::endl;
+        mtl << "Ks 0.25 0.25 0.25" << std::endl;
+        mtl << "Ns 64.0" << std::endl << std::endl;
+    }
+
+    // Vertex attributes
+    obj << "# synthetic " << size << "x" << size << " grid" << std::endl;
+    obj << "mtllib " << mtl_name << std::endl;
+    for (const glm::vec3 &vertex : position) {
+        obj << "v " << vertex.x << " " << vertex.y << " " << vertex.z << std::endl;
+    }
+    for (const glm::vec2 &vertex : uv_coord) {
+        obj << "vt " << vertex.s << " " << vertex.t << std::endl;
+    }
+    for (const glm::vec3 &vertex : normal) {
+        obj << "vn " << vertex.x << " " << vertex.y << " " << vertex.z << std::endl;
+    }
+
+    // Quad faces split in material bands
+    const int rows = std::max(size / materials, 1);
+    for (int z = 0; z < size; z++) {
+        if ((z % rows) == 0) {
+            obj << "usemtl material_" << std::min(z / rows, materials - 1) << std::endl;
+        }
+
+        for (int x = 0; x < size; x++) {
+            const int a = z * (size + 1) + x + 1;
+            obj << "f";
+            for (const int &index : {a, a + 1, a + size + 2, a + size + 1}) {
+                obj << " " << index << "/" << index << "/" << index;
+            }
+            obj << std::endl;
+        }
+    }
+
+    return true;
+}
\ No newline at end of file
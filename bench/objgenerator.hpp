@@ -0,0 +1,70 @@
+#ifndef __OBJ_GENERATOR_HPP_
+#define __OBJ_GENERATOR_HPP_
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <string>
+#include <vector>
+
+
+/** Synthetic OBJ/MTL models generator */
+class OBJGenerator {
+    private:
+        // Attributes
+
+        /** Quads per side of the grid */
+        int size;
+
+        /** Number of materials */
+        int materials;
+
+
+        /** Positions */
+        std::vector<glm::vec3> position;
+
+        /** Texture coordinates */
+        std::vector<glm::vec2> uv_coord;
+
+        /** Normals */
+        std::vector<glm::vec3> normal;
+
+        /** Triangulated face vertices as `v/vt/vn' tokens */
+        std::vector<std::string> face_vertex;
+
+
+        // Constructors
+
+        /** Disable the default constructor */
+        OBJGenerator() = delete;
+
+
+    public:
+        // Constructor
+
+        /** Generate a wavy grid with the given quads per side and materials */
+        OBJGenerator(const int &size, const int &materials = 4);
+
+
+        // Getters
+
+        /** Get the positions */
+        const std::vector<glm::vec3> &getPositions() const;
+
+        /** Get the texture coordinates */
+        const std::vector<glm::vec2> &getUVCoords() const;
+
+        /** Get the normals */
+        const std::vector<glm::vec3> &getNormals() const;
+
+        /** Get the triangulated face vertices */
+        const std::vector<std::string> &getFaceVertices() const;
+
+
+        // Methods
+
+        /** Write the OBJ file and its MTL file next to it */
+        bool write(const std::string &path) const;
+};
+
+#endif // __OBJ_GENERATOR_HPP_
\ No newline at end of file
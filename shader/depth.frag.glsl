@@ -0,0 +1,6 @@
+#version 330 core
+
+// Main function
+void main() {
+    // Only the depth is written
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#version 330 core
+
+// Location variables
+layout (location = 0) in vec3 l_position;
+
+
+// Uniform variables
+uniform mat4 u_view_mat;
+uniform mat4 u_projection_mat;
+
+uniform mat4 u_model_mat;
+
+
+// Out variables
+invariant gl_Position;
+
+
+// Main function
+void main() {
+    // Vertex position computed as in the geometry pass so the depths are equal
+    vec4 pos = u_model_mat * vec4(l_position, 1.0F);
+
+    // Set vertex position
+    gl_Position = u_projection_mat * u_view_mat * pos;
+}
\ No newline at end of file
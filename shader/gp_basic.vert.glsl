@@ -15,6 +15,8 @@ uniform mat3 u_normal_mat;
 
 
 // Out variables
+invariant gl_Position;
+
 out Vertex {
     vec3 position;
     vec2 uv_coord;
@@ -1,9 +1,5 @@
 #version 330 core
 
-// Parallax mapping layers macros
-#define MAX_LAYERS 32.0F
-#define MIN_LAYERS  8.0F
-
 // Location variables
 layout (location = 0) out vec3 l_position;
 layout (location = 1) out vec3 l_normal;
@@ -23,6 +19,8 @@ uniform float u_roughness;
 uniform float u_metalness;
 uniform float u_alpha;
 uniform float u_displacement;
+uniform float u_max_layers;
+uniform float u_min_layers;
 
 uniform sampler2D u_ambient_tex;
 uniform sampler2D u_diffuse_tex;
@@ -31,6 +29,9 @@ uniform sampler2D u_shininess_tex;
 uniform sampler2D u_normal_tex;
 uniform sampler2D u_displacement_tex;
 
+uniform float u_lod_bias;
+uniform bool u_compact;
+
 
 // In variables
 in Vertex {
@@ -44,6 +45,15 @@ in vec3 tangent_view_pos;
 in mat3 tbn;
 
 
+// Encode a normal into the octahedral map in the [0, 1] range
+vec2 octEncode(vec3 normal) {
+    normal /= abs(normal.x) + abs(normal.y) + abs(normal.z);
+    vec2 sign_xy = vec2(normal.x >= 0.0F ? 1.0F : -1.0F, normal.y >= 0.0F ? 1.0F : -1.0F);
+    vec2 encoded = normal.z >= 0.0F ? normal.xy : (1.0F - abs(normal.yx)) * sign_xy;
+    return encoded * 0.5F + 0.5F;
+}
+
+
 // Main function
 void main () {
     // Texture coordinates
@@ -57,7 +67,7 @@ void main () {
 
         // Number of layers for parallax mapping
         const vec3 up = vec3(0.0F, 0.0F, 1.0F);
-        float layers = mix(MAX_LAYERS, MIN_LAYERS, abs(dot(up, view_dir)));
+        float layers = max(mix(u_max_layers, u_min_layers, abs(dot(up, view_dir))), 1.0F);
         float layer_depth = 1.0F / layers;
 
         // Initialize variables for parallax mapping
@@ -92,24 +102,34 @@ void main () {
     l_position = vertex.position;
 
     // Normal
-    l_normal = tbn * normalize(normalize(texture(u_normal_tex, uv_coord).rgb) * 2.0F - 1.0F);
+    l_normal = tbn * normalize(normalize(texture(u_normal_tex, uv_coord, u_lod_bias).rgb) * 2.0F - 1.0F);
+
+    // Encode the octahedral normal for the compact layout
+    if (u_compact) {
+        l_normal = vec3(octEncode(l_normal), 0.0F);
+    }
 
     // Ambient color
-    l_ambient = texture(u_ambient_tex, uv_coord).rgb * u_ambient;
+    l_ambient = texture(u_ambient_tex, uv_coord, u_lod_bias).rgb * u_ambient;
 
     // Diffuse color and alpha
-    l_diffuse = texture(u_diffuse_tex, uv_coord);
+    l_diffuse = texture(u_diffuse_tex, uv_coord, u_lod_bias);
     l_diffuse.rgb *= u_diffuse;
     l_diffuse.a   *= u_alpha;
 
+    // Discard transparent fragments so they are not marked as geometry
+    if (l_diffuse.a == 0.0F) {
+        discard;
+    }
+
     // Specular color
-    l_specular = texture(u_specular_tex, uv_coord).rgb * u_specular;
+    l_specular = texture(u_specular_tex, uv_coord, u_lod_bias).rgb * u_specular;
 
 
     // Metadata
 
     // Shininess
-    l_metadata.x = texture(u_shininess_tex, uv_coord).r * u_shininess;
+    l_metadata.x = texture(u_shininess_tex, uv_coord, u_lod_bias).r * u_shininess;
 
     // Roughness
     l_metadata.y = u_roughness;
@@ -119,4 +139,9 @@ void main () {
 
     // Refractive index
     l_metadata.w = 0.0F;
+
+    // Pack the shininess into the 8-bit channel of the compact layout
+    if (u_compact) {
+        l_metadata.x = log2(l_metadata.x + 1.0F) / 10.0F;
+    }
 }
\ No newline at end of file
@@ -5,26 +5,28 @@ out vec4 color;
 
 
 // Uniform variables
-uniform vec3 u_background_color;
-
 uniform sampler2D u_normal_tex;
 
+uniform bool u_compact;
+
 
 // In variables
 in vec2 uv_coord;
 
 
-// Main function
-void main() {
-    // Get the data from the buffer textures
-    vec3 normal = texture(u_normal_tex, uv_coord).rgb;
+// Decode a normal from the octahedral map in the [0, 1] range
+vec3 octDecode(vec2 encoded) {
+    encoded = encoded * 2.0F - 1.0F;
+    vec3 normal = vec3(encoded, 1.0F - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-normal.z, 0.0F);
+    normal.xy += vec2(normal.x >= 0.0F ? -fold : fold, normal.y >= 0.0F ? -fold : fold);
+    return normalize(normal);
+}
 
-    // Discard if the normal is black
-    if (normal == vec3(0.0F)) {
-        color = vec4(u_background_color, 1.0F);
-        return;
-    }
 
+// Main function
+void main() {
     // Set the normal as color
+    vec3 normal = u_compact ? octDecode(texture(u_normal_tex, uv_coord).rg) : texture(u_normal_tex, uv_coord).rgb;
     color = vec4(normal, 1.0F);
 }
\ No newline at end of file
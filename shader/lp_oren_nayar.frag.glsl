@@ -25,8 +25,6 @@ uniform float u_shininess;
 
 uniform vec3 u_view_pos;
 
-uniform vec3 u_background_color;
-
 uniform sampler2D u_position_tex;
 uniform sampler2D u_normal_tex;
 uniform sampler2D u_ambient_tex;
@@ -34,28 +32,42 @@ uniform sampler2D u_diffuse_tex;
 uniform sampler2D u_specular_tex;
 uniform sampler2D u_metadata_tex;
 
+uniform sampler2D u_depth_tex;
+
+uniform mat4 u_inv_view_projection_mat;
+uniform bool u_compact;
+
 
 // In variables
 in vec2 uv_coord;
 
 
+// Decode a normal from the octahedral map in the [0, 1] range
+vec3 octDecode(vec2 encoded) {
+    encoded = encoded * 2.0F - 1.0F;
+    vec3 normal = vec3(encoded, 1.0F - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-normal.z, 0.0F);
+    normal.xy += vec2(normal.x >= 0.0F ? -fold : fold, normal.y >= 0.0F ? -fold : fold);
+    return normalize(normal);
+}
+
+
+// Reconstruct the world position from the depth texture
+vec3 depthPosition(vec2 uv) {
+    vec4 position = u_inv_view_projection_mat * (vec4(uv, texture(u_depth_tex, uv).r, 1.0F) * 2.0F - 1.0F);
+    return position.xyz / position.w;
+}
+
+
 // Main function
 void main() {
-    // Get the normal and fissue data from the buffer textures
-    vec3 normal        = texture(u_normal_tex, uv_coord).rgb;
+    // Get the position, normal, ambient, diffuse, specular and other metadata from the buffer textures
+    vec3 position      = u_compact ? depthPosition(uv_coord) : texture(u_position_tex, uv_coord).rgb;
+    vec3 normal        = u_compact ? octDecode(texture(u_normal_tex, uv_coord).rg) : texture(u_normal_tex, uv_coord).rgb;
+    vec3 ambient       = texture(u_ambient_tex, uv_coord).rgb;
     vec4 diffuse_alpha = texture(u_diffuse_tex, uv_coord);
-
-    // Discard black normals and transparent fragments
-    if ((diffuse_alpha.a == 0.0F) || (normal == vec3(0.0F))) {
-        color = vec4(u_background_color, 1.0F);
-        return;
-    }
-
-    // Get the position, ambient, specular and other metadata from the buffer textures
-    vec3 position = texture(u_position_tex, uv_coord).rgb;
-    vec3 ambient  = texture(u_ambient_tex, uv_coord).rgb;
-    vec3 specular = texture(u_specular_tex, uv_coord).rgb;
-    vec4 metadata = texture(u_metadata_tex, uv_coord);
+    vec3 specular      = texture(u_specular_tex, uv_coord).rgb;
+    vec4 metadata      = texture(u_metadata_tex, uv_coord);
 
     // Decompose diffuse and roughness data
     vec3 diffuse    = diffuse_alpha.rgb;
@@ -5,28 +5,27 @@ out vec4 color;
 
 
 // Uniform variables
-uniform vec3 u_background_color;
-
 uniform sampler2D u_position_tex;
-uniform sampler2D u_normal_tex;
+uniform sampler2D u_depth_tex;
+
+uniform mat4 u_inv_view_projection_mat;
+uniform bool u_compact;
 
 
 // In variables
 in vec2 uv_coord;
 
 
-// Main function
-void main() {
-    // Get the data from the buffer textures
-    vec3 normal = texture(u_normal_tex, uv_coord).rgb;
+// Reconstruct the world position from the depth texture
+vec3 depthPosition(vec2 uv) {
+    vec4 position = u_inv_view_projection_mat * (vec4(uv, texture(u_depth_tex, uv).r, 1.0F) * 2.0F - 1.0F);
+    return position.xyz / position.w;
+}
 
-    // Discard if the normal is black
-    if (normal == vec3(0.0F)) {
-        color = vec4(u_background_color, 1.0F);
-        return;
-    }
 
+// Main function
+void main() {
     // Set the position as color
-    vec3 position = texture(u_position_tex, uv_coord).rgb;
+    vec3 position = u_compact ? depthPosition(uv_coord) : texture(u_position_tex, uv_coord).rgb;
     color = vec4(position, 1.0F);
 }
\ No newline at end of file
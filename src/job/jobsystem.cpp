@@ -0,0 +1,266 @@
+#include "jobsystem.hpp"
+
+#include <algorithm>
+
+
+// Private static attributes
+
+// Queues, the first one is shared by the threads outside the system
+std::vector<JobSystem::Queue *> JobSystem::queue;
+
+// Worker threads
+std::vector<std::thread> JobSystem::worker;
+
+// Number of queued jobs
+std::atomic<std::size_t> JobSystem::queued(0U);
+
+// Stopping workers status
+std::atomic<bool> JobSystem::stopping(false);
+
+
+// Sleeping workers mutex
+std::mutex JobSystem::sleep_mutex;
+
+// Queued job condition
+std::condition_variable JobSystem::job_ready;
+
+// Workers setup mutex
+std::mutex JobSystem::setup_mutex;
+
+// Workers stopper at exit, destroyed before the rest of the attributes
+JobSystem::Stopper JobSystem::stopper;
+
+
+// Queue index of the current thread
+thread_local std::size_t JobSystem::queue_index = 0U;
+
+
+// Graph
+
+// Empty graph constructor
+JobSystem::Graph::Graph() :
+    pending(0U) {}
+
+// Add a job and get its ID
+std::size_t JobSystem::Graph::add(const std::function<void ()> &work) {
+    job.emplace_back();
+    JobSystem::Graph::Job &new_job = job.back();
+    new_job.work = work;
+    new_job.dependencies = 0U;
+    new_job.graph = this;
+    return job.size() - 1U;
+}
+
+// Run a job after the given dependency
+void JobSystem::Graph::depend(const std::size_t &job_id, const std::size_t &dependency_id) {
+    job[dependency_id].dependent.push_back(job_id);
+    job[job_id].dependencies++;
+}
+
+
+// Stopper
+
+// Stop the workers
+JobSystem::Stopper::~Stopper() {
+    JobSystem::stop();
+}
+
+
+// Private static methods
+
+// Start the default workers if there are none
+void JobSystem::start() {
+    std::lock_guard<std::mutex> lock(JobSystem::setup_mutex);
+    if (!JobSystem::queue.empty()) {
+        return;
+    }
+
+    // Leave a core to the calling thread
+    const int threads = static_cast<int>(std::thread::hardware_concurrency());
+    JobSystem::queue.push_back(new JobSystem::Queue());
+    for (std::size_t i = 1U; i < static_cast<std::size_t>(std::max(threads, 1)); i++) {
+        JobSystem::queue.push_back(new JobSystem::Queue());
+    }
+    for (std::size_t i = 1U; i < JobSystem::queue.size(); i++) {
+        JobSystem::worker.emplace_back(&JobSystem::work, i);
+    }
+}
+
+// Stop and join the workers
+void JobSystem::stop() {
+    std::lock_guard<std::mutex> lock(JobSystem::setup_mutex);
+
+    // Wake up and join the workers
+    {
+        std::lock_guard<std::mutex> sleep_lock(JobSystem::sleep_mutex);
+        JobSystem::stopping = true;
+    }
+    JobSystem::job_ready.notify_all();
+    for (std::thread &thread : JobSystem::worker) {
+        thread.join();
+    }
+
+    // Delete the queues
+    for (const JobSystem::Queue *const thread_queue : JobSystem::queue) {
+        delete thread_queue;
+    }
+    JobSystem::worker.clear();
+    JobSystem::queue.clear();
+    JobSystem::stopping = false;
+}
+
+// Worker thread loop
+void JobSystem::work(const std::size_t &index) {
+    JobSystem::queue_index = index;
+
+    while (!JobSystem::stopping) {
+        // Execute the available jobs
+        JobSystem::Graph::Job *const job = JobSystem::take();
+        if (job != nullptr) {
+            JobSystem::execute(job);
+            continue;
+        }
+
+        // Sleep until a job is queued
+        std::unique_lock<std::mutex> lock(JobSystem::sleep_mutex);
+        JobSystem::job_ready.wait(lock, [] () { return (JobSystem::queued > 0U) || JobSystem::stopping; });
+    }
+}
+
+// Push a job to the queue of the current thread
+void JobSystem::push(JobSystem::Graph::Job *const job) {
+    // Count the job before queueing it so the counter never underflows
+    JobSystem::queued++;
+    {
+        JobSystem::Queue *const thread_queue = JobSystem::queue[JobSystem::queue_index];
+        std::lock_guard<std::mutex> lock(thread_queue->mutex);
+        thread_queue->job.push_back(job);
+    }
+
+    // Lock the sleep mutex so a worker going to sleep can not miss the notification
+    {
+        std::lock_guard<std::mutex> lock(JobSystem::sleep_mutex);
+    }
+    JobSystem::job_ready.notify_one();
+}
+
+// Pop a job from the current thread queue or steal one, null if there are none
+JobSystem::Graph::Job *JobSystem::take() {
+    const std::size_t queues = JobSystem::queue.size();
+    for (std::size_t i = 0U; i < queues; i++) {
+        // Own queue from the back, the others from the front
+        JobSystem::Queue *const thread_queue = JobSystem::queue[(JobSystem::queue_index + i) % queues];
+        std::lock_guard<std::mutex> lock(thread_queue->mutex);
+        if (thread_queue->job.empty()) {
+            continue;
+        }
+
+        JobSystem::Graph::Job *job;
+        if (i == 0U) {
+            job = thread_queue->job.back();
+            thread_queue->job.pop_back();
+        }
+        else {
+            job = thread_queue->job.front();
+            thread_queue->job.pop_front();
+        }
+
+        JobSystem::queued--;
+        return job;
+    }
+
+    return nullptr;
+}
+
+// Execute a job and queue its ready dependents
+void JobSystem::execute(JobSystem::Graph::Job *const job) {
+    job->work();
+
+    // Queue the dependents without other pending dependencies
+    JobSystem::Graph *const graph = job->graph;
+    for (const std::size_t &dependent : job->dependent) {
+        if (--graph->job[dependent].remaining == 0U) {
+            JobSystem::push(&graph->job[dependent]);
+        }
+    }
+
+    // The graph may be released by its owner after this
+    graph->pending--;
+}
+
+
+// Static getters
+
+// Get the number of threads including the calling one
+int JobSystem::getThreads() {
+    JobSystem::start();
+    return static_cast<int>(JobSystem::queue.size());
+}
+
+
+// Static setters
+
+// Set the number of threads including the calling one, it must be called while no jobs run
+void JobSystem::setThreads(const int &threads) {
+    JobSystem::stop();
+
+    std::lock_guard<std::mutex> lock(JobSystem::setup_mutex);
+    JobSystem::queue.push_back(new JobSystem::Queue());
+    for (int i = 1; i < threads; i++) {
+        JobSystem::queue.push_back(new JobSystem::Queue());
+    }
+    for (std::size_t i = 1U; i < JobSystem::queue.size(); i++) {
+        JobSystem::worker.emplace_back(&JobSystem::work, i);
+    }
+}
+
+
+// Static methods
+
+// Run a graph and wait for it helping with the queued jobs
+void JobSystem::run(JobSystem::Graph &graph) {
+    JobSystem::start();
+
+    // Reset the dependencies and queue the jobs without them
+    graph.pending = graph.job.size();
+    for (JobSystem::Graph::Job &job : graph.job) {
+        job.remaining = job.dependencies;
+    }
+    for (JobSystem::Graph::Job &job : graph.job) {
+        if (job.dependencies == 0U) {
+            JobSystem::push(&job);
+        }
+    }
+
+    // Help with any queued job until the graph finishes
+    while (graph.pending > 0U) {
+        JobSystem::Graph::Job *const job = JobSystem::take();
+        if (job != nullptr) {
+            JobSystem::execute(job);
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// Run a function over the ranges of the given size in parallel and wait for them
+void JobSystem::parallelFor(const std::size_t &count, const std::size_t &grain, const std::function<void (const std::size_t &begin, const std::size_t &end)> &function) {
+    // Run small ranges in the calling thread
+    const std::size_t size = std::max<std::size_t>(grain, 1U);
+    if (count <= size) {
+        if (count > 0U) {
+            function(0U, count);
+        }
+        return;
+    }
+
+    // A job per range
+    JobSystem::Graph graph;
+    for (std::size_t begin = 0U; begin < count; begin += size) {
+        const std::size_t end = std::min(begin + size, count);
+        graph.add([&function, begin, end] () { function(begin, end); });
+    }
+
+    JobSystem::run(graph);
+}
\ No newline at end of file
@@ -0,0 +1,179 @@
+#ifndef __JOB_SYSTEM_HPP_
+#define __JOB_SYSTEM_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <deque>
+#include <vector>
+
+
+/** Work stealing job system with per thread deques, the jobs must not call OpenGL */
+class JobSystem {
+    public:
+        /** Graph of jobs with dependencies, it must outlive its run */
+        class Graph {
+            /** The job system runs the graph jobs */
+            friend class JobSystem;
+
+            private:
+                // Structs
+
+                /** Graph job */
+                struct Job {
+                    /** Work function */
+                    std::function<void ()> work;
+
+                    /** Jobs waiting for this one */
+                    std::vector<std::size_t> dependent;
+
+                    /** Number of dependencies */
+                    std::size_t dependencies;
+
+                    /** Dependencies not finished yet */
+                    std::atomic<std::size_t> remaining;
+
+                    /** Owner graph */
+                    JobSystem::Graph *graph;
+                };
+
+
+                // Attributes
+
+                /** Jobs stock with stable addresses */
+                std::deque<JobSystem::Graph::Job> job;
+
+                /** Jobs not finished yet */
+                std::atomic<std::size_t> pending;
+
+
+                // Constructors
+
+                /** Disable the default copy constructor */
+                Graph(const Graph &) = delete;
+
+                /** Disable the assignation operator */
+                Graph &operator=(const Graph &) = delete;
+
+
+            public:
+                // Constructor
+
+                /** Empty graph constructor */
+                Graph();
+
+
+                // Methods
+
+                /** Add a job and get its ID */
+                std::size_t add(const std::function<void ()> &work);
+
+                /** Run a job after the given dependency */
+                void depend(const std::size_t &job_id, const std::size_t &dependency_id);
+        };
+
+
+    private:
+        // Structs
+
+        /** Double ended queue of a thread, the owner pops from the back and the thieves from the front */
+        struct Queue {
+            /** Queue mutex */
+            std::mutex mutex;
+
+            /** Queued jobs */
+            std::deque<JobSystem::Graph::Job *> job;
+        };
+
+        /** Workers stopper at exit */
+        struct Stopper {
+            /** Stop the workers */
+            ~Stopper();
+        };
+
+
+        // Static attributes
+
+        /** Queues, the first one is shared by the threads outside the system */
+        static std::vector<JobSystem::Queue *> queue;
+
+        /** Worker threads */
+        static std::vector<std::thread> worker;
+
+        /** Number of queued jobs */
+        static std::atomic<std::size_t> queued;
+
+        /** Stopping workers status */
+        static std::atomic<bool> stopping;
+
+
+        /** Sleeping workers mutex */
+        static std::mutex sleep_mutex;
+
+        /** Queued job condition */
+        static std::condition_variable job_ready;
+
+        /** Workers setup mutex */
+        static std::mutex setup_mutex;
+
+        /** Workers stopper at exit */
+        static JobSystem::Stopper stopper;
+
+
+        /** Queue index of the current thread */
+        static thread_local std::size_t queue_index;
+
+
+        // Static methods
+
+        /** Start the default workers if there are none */
+        static void start();
+
+        /** Stop and join the workers */
+        static void stop();
+
+        /** Worker thread loop */
+        static void work(const std::size_t &index);
+
+        /** Push a job to the queue of the current thread */
+        static void push(JobSystem::Graph::Job *const job);
+
+        /** Pop a job from the current thread queue or steal one, null if there are none */
+        static JobSystem::Graph::Job *take();
+
+        /** Execute a job and queue its ready dependents */
+        static void execute(JobSystem::Graph::Job *const job);
+
+
+    public:
+        // Constructors
+
+        /** Disable the default constructor */
+        JobSystem() = delete;
+
+
+        // Static getters
+
+        /** Get the number of threads including the calling one */
+        static int getThreads();
+
+
+        // Static setters
+
+        /** Set the number of threads including the calling one, it must be called while no jobs run */
+        static void setThreads(const int &threads);
+
+
+        // Static methods
+
+        /** Run a graph and wait for it helping with the queued jobs */
+        static void run(JobSystem::Graph &graph);
+
+        /** Run a function over the ranges of the given size in parallel and wait for them */
+        static void parallelFor(const std::size_t &count, const std::size_t &grain, const std::function<void (const std::size_t &begin, const std::size_t &end)> &function);
+};
+
+#endif // __JOB_SYSTEM_HPP_
\ No newline at end of file
@@ -1,31 +1,196 @@
 #include "scene/gui/interactivescene.hpp"
+#include "scene/benchmarkscene.hpp"
+#include "scene/thumbnailscene.hpp"
 
+#include "model/loader/modelloader.hpp"
+
+#include "job/jobsystem.hpp"
+#include "profiler/profiler.hpp"
 #include "dirsep.h"
 
 #include <glm/vec3.hpp>
 
 #include <iostream>
 
+#include <cstdlib>
 
-/** Main function */
-int main (int argc, char **argv) {
-    // Print arguments
-    for (int i = 0; i < argc; i++) {
-        std::cout << "argv[" << i << "]: " << argv[i] << std::endl;
-    }
 
+/** Add the shading programs and get the normal and parallax mapping programs */
+static void addPrograms(Scene *const scene, const std::string &shader_path, std::size_t &normal, std::size_t &parallax) {
+    const std::string common_lp_path = shader_path + "lp_common.vert.glsl";
+    scene->setDefaultGeometryPassProgram("[GP] Basic shading", shader_path + "gp_basic.vert.glsl", shader_path + "gp_basic.frag.glsl");
+    scene->setDefaultLightingPassProgram("[LP] Normals",       common_lp_path,                     shader_path + "lp_normals.frag.glsl");
+    scene->setDepthProgram(shader_path + "depth.vert.glsl", shader_path + "depth.frag.glsl");
+
+    const std::string gp_normal_vert_path = shader_path + "gp_normal.vert.glsl";
+    normal   = scene->addProgram("[GP] Normal mapping", gp_normal_vert_path, shader_path + "gp_normal.frag.glsl");
+    parallax = scene->addProgram("[GP] Parallax mapping", gp_normal_vert_path, shader_path + "gp_parallax.frag.glsl");
+
+    scene->addProgram("[LP] Positions", common_lp_path, shader_path + "lp_positions.frag.glsl");
+
+    scene->addProgram("[LP] Blinn-Phong", common_lp_path, shader_path + "lp_blinn_phong.frag.glsl");
+    scene->addProgram("[LP] Oren-Nayar",  common_lp_path, shader_path + "lp_oren_nayar.frag.glsl");
+    std::size_t lp_program = scene->addProgram("[LP] Cock-Torrance", common_lp_path, shader_path + "lp_cock_torrance.frag.glsl");
+
+    scene->setLightingPassProgram(lp_program);
+}
+
+/** Run a benchmark scenario and write its report */
+static int benchmark(const std::string &name, const bool &headless, const bool &depth_prepass, const int &frames, const std::string &camera_path, const std::string &mesh_path, const std::string &report_path, const std::string &model_path, const std::string &shader_path) {
+    // Get the scenario
+    BenchmarkScene::Scenario scenario;
+    if (!BenchmarkScene::getScenario(name, scenario)) {
+        std::cerr << "error: unknown benchmark scenario `" << name << "' (many_models, many_lights, parallax_heavy, large_mesh)" << std::endl;
+        return 1;
+    }
 
     // Create the scene and check it
-    InteractiveScene *scene = new InteractiveScene("OBJViewer");
+    BenchmarkScene *scene = new BenchmarkScene("OBJViewer benchmark", 1280, 720, headless);
+    if (!scene->isValid()) {
+        delete scene;
+        return 1;
+    }
 
-    // Exit with error if the scene is not valid
+    // Set the background color, the frames and the depth pre-pass
+    scene->setBackgroundColor(glm::vec3(0.45F, 0.55F, 0.60F));
+    scene->setFrames(frames);
+    scene->setDepthPrepassEnabled(depth_prepass);
+
+    // Add the programs measuring their build time
+    std::size_t normal;
+    std::size_t parallax;
+    const double start = glfwGetTime();
+    addPrograms(scene, shader_path, normal, parallax);
+    scene->addLoadPhase("programs", (glfwGetTime() - start) * 1000.0);
+
+    // Setup the scenario and the recorded camera path, then run
+    bool status = scene->setupScenario(scenario, model_path, normal, parallax, mesh_path);
+    status = status && (camera_path.empty() || scene->setCameraPath(camera_path));
+    status = status && scene->run(report_path);
+
+    // Clean up
+    delete scene;
+    return status ? 0 : 1;
+}
+
+/** Render the thumbnails of the listed models */
+static int thumbnails(const std::string &input, const std::string &output_dir, const int &size, const int &views, const int &threads, const std::string &shader_path) {
+    // Get the models
+    const std::vector<std::string> path = ThumbnailScene::listModels(input);
+    if (path.empty()) {
+        std::cerr << "error: there are no models to render in `" << input << "'" << std::endl;
+        return 1;
+    }
+
+    // Create the scene and check it
+    ThumbnailScene *scene = new ThumbnailScene(size, size);
     if (!scene->isValid()) {
         delete scene;
         return 1;
     }
 
-    // Set the background color
+    // Setup the scene
+    std::size_t normal;
+    std::size_t parallax;
+    addPrograms(scene, shader_path, normal, parallax);
     scene->setBackgroundColor(glm::vec3(0.45F, 0.55F, 0.60F));
+    scene->setModelProgram(normal);
+    scene->setViews(views);
+    if (threads > 0) {
+        scene->setThreads(threads);
+    }
+
+    // Render and clean up
+    const bool status = scene->render(path, output_dir);
+    delete scene;
+    return status ? 0 : 1;
+}
+
+
+/** Main function */
+int main (int argc, char **argv) {
+    // Print arguments
+    for (int i = 0; i < argc; i++) {
+        std::cout << "argv[" << i << "]: " << argv[i] << std::endl;
+    }
+
+    // Parse the startup trace path and the benchmark options
+    std::string trace_path;
+    std::string bench_name;
+    std::string camera_path;
+    std::string mesh_path;
+    std::string report_path = "objviewer_bench.json";
+    std::string thumbnails_input;
+    std::string output_dir = ".";
+    int frames = 600;
+    int size = 256;
+    int views = ThumbnailScene::VIEWS;
+    int threads = 0;
+    int jobs = 0;
+    bool headless = false;
+    bool depth_prepass = false;
+    bool split_streams = false;
+    for (int i = 1; i < argc; i++) {
+        const std::string option = argv[i];
+        if (option == "--headless") {
+            headless = true;
+        }
+        else if (option == "--depth-prepass") {
+            depth_prepass = true;
+        }
+        else if (option == "--split-streams") {
+            split_streams = true;
+        }
+        else if (i == argc - 1) {
+            break;
+        }
+        else if (option == "--trace") {
+            trace_path = argv[++i];
+        }
+        else if (option == "--bench") {
+            bench_name = argv[++i];
+        }
+        else if (option == "--frames") {
+            frames = std::atoi(argv[++i]);
+        }
+        else if (option == "--camera-path") {
+            camera_path = argv[++i];
+        }
+        else if (option == "--mesh") {
+            mesh_path = argv[++i];
+        }
+        else if (option == "--report") {
+            report_path = argv[++i];
+        }
+        else if (option == "--thumbnails") {
+            thumbnails_input = argv[++i];
+        }
+        else if (option == "--output") {
+            output_dir = argv[++i];
+        }
+        else if (option == "--size") {
+            size = std::atoi(argv[++i]);
+        }
+        else if (option == "--views") {
+            views = std::atoi(argv[++i]);
+        }
+        else if (option == "--threads") {
+            threads = std::atoi(argv[++i]);
+        }
+        else if (option == "--jobs") {
+            jobs = std::atoi(argv[++i]);
+        }
+    }
+
+    // Set the job system threads
+    if (jobs > 0) {
+        JobSystem::setThreads(jobs);
+    }
+
+    // Set the vertex buffers layout before any model is loaded
+    if (split_streams) {
+        ModelLoader::setVertexLayout(ModelLoader::SPLIT);
+    }
 
 
     // Setup directories
@@ -36,22 +201,35 @@ int main (int argc, char **argv) {
     const std::string shader_path = relative + ".." + DIR_SEP + "shader" + DIR_SEP;
 
 
-    // Add the programs
-    const std::string common_lp_path = shader_path + "lp_common.vert.glsl";
-    scene->setDefaultGeometryPassProgram("[GP] Basic shading", shader_path + "gp_basic.vert.glsl", shader_path + "gp_basic.frag.glsl");
-    scene->setDefaultLightingPassProgram("[LP] Normals",       common_lp_path,                     shader_path + "lp_normals.frag.glsl");
+    // Run the benchmark instead of the interactive scene
+    if (!bench_name.empty()) {
+        return benchmark(bench_name, headless, depth_prepass, frames, camera_path, mesh_path, report_path, model_path, shader_path);
+    }
 
-    const std::string gp_normal_vert_path = shader_path + "gp_normal.vert.glsl";
-    std::size_t normal   = scene->addProgram("[GP] Normal mapping", gp_normal_vert_path, shader_path + "gp_normal.frag.glsl");
-    std::size_t parallax = scene->addProgram("[GP] Parallax mapping", gp_normal_vert_path, shader_path + "gp_parallax.frag.glsl");
+    // Render the thumbnails instead of the interactive scene
+    if (!thumbnails_input.empty()) {
+        return thumbnails(thumbnails_input, output_dir, size, views, threads, shader_path);
+    }
 
-    scene->addProgram("[LP] Positions", common_lp_path, shader_path + "lp_positions.frag.glsl");
 
-    scene->addProgram("[LP] Blinn-Phong", common_lp_path, shader_path + "lp_blinn_phong.frag.glsl");
-    scene->addProgram("[LP] Oren-Nayar",  common_lp_path, shader_path + "lp_oren_nayar.frag.glsl");
-    std::size_t lp_program = scene->addProgram("[LP] Cock-Torrance", common_lp_path, shader_path + "lp_cock_torrance.frag.glsl");
+    // Create the scene and check it
+    InteractiveScene *scene = new InteractiveScene("OBJViewer");
+
+    // Exit with error if the scene is not valid
+    if (!scene->isValid()) {
+        delete scene;
+        return 1;
+    }
+
+    // Set the background color and the depth pre-pass
+    scene->setBackgroundColor(glm::vec3(0.45F, 0.55F, 0.60F));
+    scene->setDepthPrepassEnabled(depth_prepass);
 
-    scene->setLightingPassProgram(lp_program);
+
+    // Add the programs
+    std::size_t normal;
+    std::size_t parallax;
+    addPrograms(scene, shader_path, normal, parallax);
 
 
     // Add the models
@@ -71,6 +249,12 @@ int main (int argc, char **argv) {
     model->setPosition(glm::vec3(0.6F, -0.225F, 0.0F));
 
 
+    // Dump the startup trace
+    if (!trace_path.empty()) {
+        Profiler::dump(trace_path);
+    }
+
+
     // Esecute the main loop
     scene->mainLoop();
 
@@ -0,0 +1,91 @@
+#include "arena.hpp"
+
+#include <algorithm>
+
+#include <cstdint>
+#include <cstring>
+
+
+// Constructor
+
+// Arena constructor
+Arena::Arena(const std::size_t &block_size) :
+    block_size(std::max<std::size_t>(block_size, 64U)),
+    used(0U),
+    capacity(0U),
+    allocations(0U),
+    bytes(0U),
+    blocks(0U) {}
+
+
+// Getters
+
+// Get the number of served allocations
+std::size_t Arena::getAllocations() const {
+    return allocations;
+}
+
+// Get the number of served bytes
+std::size_t Arena::getBytes() const {
+    return bytes;
+}
+
+// Get the number of heap allocated blocks
+std::size_t Arena::getBlocks() const {
+    return blocks;
+}
+
+
+// Methods
+
+// Allocate aligned memory that lives until the release
+void *Arena::allocate(const std::size_t &size, const std::size_t &alignment) {
+    // Align the offset in the last block
+    std::size_t offset = 0U;
+    if (!block.empty()) {
+        const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block.back() + used);
+        offset = used + (alignment - address % alignment) % alignment;
+    }
+
+    // Take a new block if it does not fit, oversized requests get their own block
+    if (block.empty() || (offset + size > capacity)) {
+        capacity = std::max(block_size, size + alignment);
+        block.push_back(new char[capacity]);
+        blocks++;
+        const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block.back());
+        offset = (alignment - address % alignment) % alignment;
+    }
+
+    // Bump the offset
+    used = offset + size;
+    allocations++;
+    bytes += size;
+
+    return block.back() + offset;
+}
+
+// Copy a string into the arena without the null terminator
+const char *Arena::copy(const char *const data, const std::size_t &size) {
+    char *const destination = static_cast<char *>(allocate(size, 1U));
+    std::memcpy(destination, data, size);
+    return destination;
+}
+
+// Release all the allocations at once, the counters are kept
+void Arena::release() {
+    for (char *const memory : block) {
+        delete[] memory;
+    }
+
+    block.clear();
+    used = 0U;
+    capacity = 0U;
+}
+
+
+// Destructor
+
+// Arena destructor
+Arena::~Arena() {
+    release();
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#ifndef __ARENA_HPP_
+#define __ARENA_HPP_
+
+#include <cstddef>
+
+#include <vector>
+
+
+/** Bump allocator that owns the parse time temporaries and releases them at once */
+class Arena {
+    private:
+        // Attributes
+
+        /** Memory blocks */
+        std::vector<char *> block;
+
+        /** Size of the new blocks */
+        std::size_t block_size;
+
+        /** Used bytes of the last block */
+        std::size_t used;
+
+        /** Size of the last block */
+        std::size_t capacity;
+
+
+        /** Number of served allocations */
+        std::size_t allocations;
+
+        /** Number of served bytes */
+        std::size_t bytes;
+
+        /** Number of heap allocated blocks */
+        std::size_t blocks;
+
+
+        // Constructors
+
+        /** Disable the default copy constructor */
+        Arena(const Arena &) = delete;
+
+        /** Disable the assignation operator */
+        Arena &operator=(const Arena &) = delete;
+
+
+    public:
+        // Constructor
+
+        /** Arena constructor */
+        Arena(const std::size_t &block_size = 65536U);
+
+
+        // Getters
+
+        /** Get the number of served allocations */
+        std::size_t getAllocations() const;
+
+        /** Get the number of served bytes */
+        std::size_t getBytes() const;
+
+        /** Get the number of heap allocated blocks */
+        std::size_t getBlocks() const;
+
+
+        // Methods
+
+        /** Allocate aligned memory that lives until the release */
+        void *allocate(const std::size_t &size, const std::size_t &alignment = alignof(std::max_align_t));
+
+        /** Copy a string into the arena without the null terminator */
+        const char *copy(const char *const data, const std::size_t &size);
+
+        /** Release all the allocations at once, the counters are kept */
+        void release();
+
+
+        // Destructor
+
+        /** Arena destructor */
+        virtual ~Arena();
+};
+
+
+/** Standard allocator adapter over an arena, the deallocation is deferred to the arena release */
+template <typename T>
+class ArenaAllocator {
+    public:
+        // Types
+
+        /** Allocated type */
+        typedef T value_type;
+
+
+        // Attributes
+
+        /** Arena */
+        Arena *arena;
+
+
+        // Constructors
+
+        /** Arena allocator constructor */
+        explicit ArenaAllocator(Arena *const arena) :
+            arena(arena) {}
+
+        /** Rebind constructor */
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U> &other) :
+            arena(other.arena) {}
+
+
+        // Methods
+
+        /** Allocate from the arena */
+        T *allocate(const std::size_t n) {
+            return static_cast<T *>(arena->allocate(sizeof(T) * n, alignof(T)));
+        }
+
+        /** Deallocations are released with the arena */
+        void deallocate(T *const, const std::size_t) {}
+
+
+        // Operators
+
+        /** Equal allocators share the arena */
+        template <typename U>
+        bool operator==(const ArenaAllocator<U> &other) const {
+            return arena == other.arena;
+        }
+
+        /** Different allocators do not share the arena */
+        template <typename U>
+        bool operator!=(const ArenaAllocator<U> &other) const {
+            return arena != other.arena;
+        }
+};
+
+#endif // __ARENA_HPP_
\ No newline at end of file
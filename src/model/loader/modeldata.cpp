@@ -4,10 +4,12 @@
 // Structs
 
 // Object constructor
-ModelData::Object::Object(const GLsizei &count, const GLsizei &offset, Material *const material) :
+ModelData::Object::Object(const GLsizei &count, const GLsizei &offset, const std::size_t &material) :
     count(count),
     offset(sizeof(GLsizei) * offset),
-    material(material) {}
+    material(material),
+    min(INFINITY),
+    max(-INFINITY) {}
 
 
 // Constructor
@@ -29,24 +31,24 @@ ModelData::ModelData(const std::string &path) :
     // Buffers
     vao(GL_FALSE),
     vbo(GL_FALSE),
+    attribute_vbo(GL_FALSE),
     ebo(GL_FALSE),
+    basic_vao(GL_FALSE),
+    depth_vao(GL_FALSE),
+    tangent_vbo(GL_FALSE),
 
     // Statistics
     vertices(0U),
     elements(0U),
     triangles(0U),
-    textures(0U) {}
+    textures(0U),
+    load_memory(0L) {}
 
 
 // Destructor
 
 // Model data destructor
 ModelData::~ModelData() {
-    // Delete all objects
-    for (const ModelData::Object *const object : object_stock) {
-        delete object;
-    }
-
     // Delete all materials
     for (const Material *const material : material_stock) {
         delete material;
@@ -29,14 +29,20 @@ class ModelData {
             /** Index offset */
             GLsizei offset;
 
-            /** Material */
-            Material *material;
+            /** Material index in the material stock */
+            std::size_t material;
+
+            /** Minimum position values */
+            glm::vec3 min;
+
+            /** Maximum position values */
+            glm::vec3 max;
 
 
             // Constructor
 
             /** Object data constructor */
-            Object(const GLsizei &count = 0, const GLsizei &offset = 0, Material *const material = nullptr);
+            Object(const GLsizei &count = 0, const GLsizei &offset = 0, const std::size_t &material = 0U);
         };
 
 
@@ -69,19 +75,37 @@ class ModelData {
         /** Vertex array object */
         GLuint vao;
 
-        /** Vertex buffer object */
+        /** Vertex buffer object, only the positions in the split layout */
         GLuint vbo;
 
+        /** Attributes vertex buffer object of the split layout */
+        GLuint attribute_vbo;
+
         /** Element buffer object */
         GLuint ebo;
 
+        /** Vertex array object without tangents of the programs that do not read them */
+        GLuint basic_vao;
+
+        /** Position only vertex array object of the depth passes */
+        GLuint depth_vao;
+
+        /** Tangents vertex buffer object, generated on the first use by a program reading them */
+        GLuint tangent_vbo;
 
-        /** Object stock */
-        std::vector<ModelData::Object *> object_stock;
+
+        /** Object stock stored contiguously */
+        std::vector<ModelData::Object> object_stock;
 
         /** Material stock */
         std::vector<Material *> material_stock;
 
+        /** Occluder triangles positions, a subset of the mesh so it never hides more than the mesh */
+        std::vector<glm::vec3> occluder_stock;
+
+        /** Object of each occluder triangle, only the opaque objects occlude */
+        std::vector<std::size_t> occluder_object;
+
 
         /** Number of vertices */
         std::size_t vertices;
@@ -95,6 +119,9 @@ class ModelData {
         /** Number of textures */
         std::size_t textures;
 
+        /** Largest resident set size growth of the process sampled during the load in kilobytes */
+        long load_memory;
+
 
         // Constructors
 
@@ -2,14 +2,49 @@
 
 #include "objloader.hpp"
 
+#include "../../job/jobsystem.hpp"
+#include "../../profiler/profiler.hpp"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+
 
 // Static attributes
 
 // Space characters
 const std::string ModelLoader::space = " \t\n\r\f\v";
 
+// Vertex buffers layout of the next uploads
+ModelLoader::Layout ModelLoader::vertex_layout = ModelLoader::INTERLEAVED;
+
+
+// Static const attributes
+
+// Maximum number of occluder triangles
+const std::size_t ModelLoader::OCCLUDER_TRIANGLES;
+
+// Smallest texture mapping area and squared tangent length taken as non degenerate
+const float ModelLoader::TANGENT_EPSILON = 1.0E-12F;
+
+// Memory bound of the extra tangent accumulation buffers of the threads in bytes
+const std::size_t ModelLoader::TANGENT_MEMORY;
+
+// Vertices per gathered chunk of the split uploads
+const std::size_t ModelLoader::UPLOAD_CHUNK;
+
 
 // Structs
 
@@ -17,59 +52,542 @@ const std::string ModelLoader::space = " \t\n\r\f\v";
 ModelLoader::Vertex::Vertex() :
     position(0.0F),
     uv_coord(0.0F),
-    normal(0.0F),
-    tangent(0.0F) {}
+    normal(0.0F) {}
+
+// Token constructor
+ModelLoader::Token::Token(const char *const data, const std::size_t &size) :
+    data(data),
+    size(size) {}
+
+// Less than comparison
+bool ModelLoader::TokenLess::operator()(const ModelLoader::Token &a, const ModelLoader::Token &b) const {
+    const int result = std::memcmp(a.data, b.data, std::min(a.size, b.size));
+    return result == 0 ? a.size < b.size : result < 0;
+}
+
+// Greater than comparison
+bool ModelLoader::OccluderLarger::operator()(const ModelLoader::OccluderTriangle &a, const ModelLoader::OccluderTriangle &b) const {
+    return a.area > b.area;
+}
 
 
 // Constructors
 
 // Model loader constructor
 ModelLoader::ModelLoader(const std::string &path) :
-    model_data(new ModelData(path)) {}
+    model_data(new ModelData(path)),
+    parsed_vertex(ModelLoader::TokenLess(), ModelLoader::VertexMap::allocator_type(&arena)),
+    unassigned_min(INFINITY),
+    unassigned_max(-INFINITY),
+    direct(false),
+    vertex_capacity(0U),
+    index_capacity(0U),
+    vertex_count(0U),
+    index_count(0U),
+    mapped_first(0U),
+    mapped_vertex(nullptr),
+    mapped_position(nullptr),
+    mapped_attributes(nullptr),
+    mapped_index(nullptr),
+    start_memory(0L),
+    sampled_memory(0L) {}
 
 
 // Private methods
 
-// Load data to GPU
-void ModelLoader::load() {
-    // Vertex array object
-    glGenVertexArrays(1, &model_data->vao);
-    glBindVertexArray(model_data->vao);
+// Upload the vertex and index stocks to new buffers, the split streams are gathered in chunks
+void ModelLoader::uploadBuffers() {
+    // Stored vertices and indices
+    const std::size_t vertices = vertex_stock.size();
+    const std::size_t indices = index_stock.size();
 
-    // Vertex buffer object
+    // Vertex buffer object, only the tightly packed positions in the split layout
     glGenBuffers(1, &model_data->vbo);
     glBindBuffer(GL_ARRAY_BUFFER, model_data->vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(ModelLoader::Vertex) * vertex_stock.size(), &vertex_stock[0], GL_STATIC_DRAW);
+    if (ModelLoader::vertex_layout == ModelLoader::SPLIT) {
+        glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * vertices, nullptr, GL_STATIC_DRAW);
+
+        // Attributes vertex buffer object
+        glGenBuffers(1, &model_data->attribute_vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, model_data->attribute_vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(ModelLoader::VertexAttributes) * vertices, nullptr, GL_STATIC_DRAW);
+
+        // Gather and upload the streams of each chunk
+        std::vector<glm::vec3> position;
+        std::vector<ModelLoader::VertexAttributes> attributes;
+        for (std::size_t first = 0U; first < vertices; first += ModelLoader::UPLOAD_CHUNK) {
+            const std::size_t count = std::min(ModelLoader::UPLOAD_CHUNK, vertices - first);
+            position.resize(count);
+            attributes.resize(count);
+            for (std::size_t i = 0U; i < count; i++) {
+                position[i] = vertex_stock[first + i].position;
+                attributes[i].uv_coord = vertex_stock[first + i].uv_coord;
+                attributes[i].normal = vertex_stock[first + i].normal;
+            }
+
+            glBindBuffer(GL_ARRAY_BUFFER, model_data->vbo);
+            glBufferSubData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * first, sizeof(glm::vec3) * count, &position[0]);
+            glBindBuffer(GL_ARRAY_BUFFER, model_data->attribute_vbo);
+            glBufferSubData(GL_ARRAY_BUFFER, sizeof(ModelLoader::VertexAttributes) * first, sizeof(ModelLoader::VertexAttributes) * count, &attributes[0]);
+        }
+    }
+    else {
+        glBufferData(GL_ARRAY_BUFFER, sizeof(ModelLoader::Vertex) * vertices, &vertex_stock[0], GL_STATIC_DRAW);
+    }
+
+    // Free the vertices before the indices upload
+    sampleMemory();
+    std::vector<ModelLoader::Vertex>().swap(vertex_stock);
 
     // Element array buffer
     glGenBuffers(1, &model_data->ebo);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model_data->ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * index_stock.size(), &index_stock[0], GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * indices, &index_stock[0], GL_STATIC_DRAW);
 
-    // Position attribute
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ModelLoader::Vertex), reinterpret_cast<void *>(offsetof(ModelLoader::Vertex, position)));
+    // Free the indices
+    std::vector<GLsizei>().swap(index_stock);
+}
 
-    // Texture coordinate attribute
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ModelLoader::Vertex), reinterpret_cast<void *>(offsetof(ModelLoader::Vertex, uv_coord)));
+// Load data to GPU
+void ModelLoader::load() {
+    // Vertex array object
+    glGenVertexArrays(1, &model_data->vao);
+    glBindVertexArray(model_data->vao);
+
+    // Upload the stocks unless the buffers were written directly
+    if (!direct) {
+        uploadBuffers();
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model_data->ebo);
 
-    // Normal attribute
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(ModelLoader::Vertex), reinterpret_cast<void *>(offsetof(ModelLoader::Vertex, normal)));
+    // Buffers, strides and offsets of each attribute
+    GLuint attribute_vbo = model_data->vbo;
+    GLsizei position_stride = sizeof(ModelLoader::Vertex);
+    GLsizei attribute_stride = sizeof(ModelLoader::Vertex);
+    std::size_t uv_coord_offset = offsetof(ModelLoader::Vertex, uv_coord);
+    std::size_t normal_offset = offsetof(ModelLoader::Vertex, normal);
+    if (ModelLoader::vertex_layout == ModelLoader::SPLIT) {
+        attribute_vbo = model_data->attribute_vbo;
+        position_stride = sizeof(glm::vec3);
+        attribute_stride = sizeof(ModelLoader::VertexAttributes);
+        uv_coord_offset = offsetof(ModelLoader::VertexAttributes, uv_coord);
+        normal_offset = offsetof(ModelLoader::VertexAttributes, normal);
+    }
+
+    // Position, texture coordinate and normal attributes, the tangents are attached on their first use
+    ModelLoader::setAttribute(0, 3, model_data->vbo, position_stride, 0U);
+    ModelLoader::setAttribute(1, 2, attribute_vbo, attribute_stride, uv_coord_offset);
+    ModelLoader::setAttribute(2, 3, attribute_vbo, attribute_stride, normal_offset);
+
+    // Vertex array object without tangents sharing the buffers
+    glGenVertexArrays(1, &model_data->basic_vao);
+    glBindVertexArray(model_data->basic_vao);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model_data->ebo);
+    ModelLoader::setAttribute(0, 3, model_data->vbo, position_stride, 0U);
+    ModelLoader::setAttribute(1, 2, attribute_vbo, attribute_stride, uv_coord_offset);
+    ModelLoader::setAttribute(2, 3, attribute_vbo, attribute_stride, normal_offset);
 
-    // Tangent attribute
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(ModelLoader::Vertex), reinterpret_cast<void *>(offsetof(ModelLoader::Vertex, tangent)));
+    // Position only vertex array object sharing the buffers
+    glGenVertexArrays(1, &model_data->depth_vao);
+    glBindVertexArray(model_data->depth_vao);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model_data->ebo);
+    ModelLoader::setAttribute(0, 3, model_data->vbo, position_stride, 0U);
 
     // Unbind vertex array object
     glBindVertexArray(GL_FALSE);
+}
+
+
+// Update the position limits with a vertex position
+void ModelLoader::updateLimits(const glm::vec3 &position) {
+    if (position.x < model_data->min.x) model_data->min.x = position.x;
+    if (position.y < model_data->min.y) model_data->min.y = position.y;
+    if (position.z < model_data->min.z) model_data->min.z = position.z;
+    if (position.x > model_data->max.x) model_data->max.x = position.x;
+    if (position.y > model_data->max.y) model_data->max.y = position.y;
+    if (position.z > model_data->max.z) model_data->max.z = position.z;
+}
+
+// Store a new vertex in the mapped buffers or in the vertex stock
+void ModelLoader::pushVertex(const ModelLoader::Vertex &vertex) {
+    // Stock for the later upload
+    if (!direct) {
+        vertex_stock.push_back(vertex);
+    }
+
+    // Mapped buffers grown when full, the failures are reported when unmapping
+    else if ((vertex_count < vertex_capacity) || ((vertex_count == vertex_capacity) && growVertexBuffers())) {
+        const std::size_t i = vertex_count - mapped_first;
+        if (mapped_vertex != nullptr) {
+            mapped_vertex[i] = vertex;
+        }
+        else {
+            mapped_position[i] = vertex.position;
+            mapped_attributes[i].uv_coord = vertex.uv_coord;
+            mapped_attributes[i].normal = vertex.normal;
+        }
+    }
+
+    vertex_count++;
+}
+
+// Store an index in the mapped buffer or in the index stock
+void ModelLoader::pushIndex(const GLsizei &index) {
+    // Stock for the later upload
+    if (!direct) {
+        index_stock.push_back(index);
+    }
+
+    // Mapped buffer, the overflows are reported when unmapping
+    else if (index_count < index_capacity) {
+        mapped_index[index_count] = index;
+    }
+
+    index_count++;
+}
+
+// Update the current object bounds and the occluder candidates with a triangle
+void ModelLoader::addTriangle(const glm::vec3 &position_0, const glm::vec3 &position_1, const glm::vec3 &position_2) {
+    // Current object bounds
+    glm::vec3 &object_min = model_data->object_stock.empty() ? unassigned_min : model_data->object_stock.back().min;
+    glm::vec3 &object_max = model_data->object_stock.empty() ? unassigned_max : model_data->object_stock.back().max;
+    object_min = glm::min(glm::min(object_min, position_0), glm::min(position_1, position_2));
+    object_max = glm::max(glm::max(object_max, position_0), glm::max(position_1, position_2));
+
+    // Keep the triangle if the occluder is not full or it is larger than the smallest kept one
+    ModelLoader::OccluderTriangle triangle;
+    triangle.area = glm::length(glm::cross(position_1 - position_0, position_2 - position_0));
+    if (occluder_heap.size() == ModelLoader::OCCLUDER_TRIANGLES) {
+        if (!(triangle.area > occluder_heap.front().area)) {
+            return;
+        }
+
+        std::pop_heap(occluder_heap.begin(), occluder_heap.end(), ModelLoader::OccluderLarger());
+        occluder_heap.pop_back();
+    }
+
+    triangle.position[0] = position_0;
+    triangle.position[1] = position_1;
+    triangle.position[2] = position_2;
+    triangle.object = model_data->object_stock.empty() ? 0U : model_data->object_stock.size() - 1U;
+    occluder_heap.push_back(triangle);
+    std::push_heap(occluder_heap.begin(), occluder_heap.end(), ModelLoader::OccluderLarger());
+}
+
+// Keep the largest triangles as occluder
+void ModelLoader::buildOccluder() {
+    model_data->occluder_stock.reserve(occluder_heap.size() * 3U);
+    model_data->occluder_object.reserve(occluder_heap.size());
+    for (const ModelLoader::OccluderTriangle &triangle : occluder_heap) {
+        model_data->occluder_stock.insert(model_data->occluder_stock.end(), triangle.position, triangle.position + 3);
+        model_data->occluder_object.push_back(triangle.object);
+    }
+
+    std::vector<ModelLoader::OccluderTriangle>().swap(occluder_heap);
+}
+
+
+// Create and map the buffers from the pre-scan sizes, false if they could not be mapped and the stocks are used instead
+bool ModelLoader::mapBuffers() {
+    // Nothing to map
+    if ((vertex_capacity == 0U) || (index_capacity == 0U)) {
+        return false;
+    }
+
+    // Vertex buffers, only the tightly packed positions in the vertex buffer object of the split layout
+    mapped_first = 0U;
+    if (ModelLoader::vertex_layout == ModelLoader::SPLIT) {
+        mapped_position = static_cast<glm::vec3 *>(ModelLoader::mapBuffer(model_data->vbo, sizeof(glm::vec3) * vertex_capacity));
+        mapped_attributes = static_cast<ModelLoader::VertexAttributes *>(ModelLoader::mapBuffer(model_data->attribute_vbo, sizeof(ModelLoader::VertexAttributes) * vertex_capacity));
+    }
+    else {
+        mapped_vertex = static_cast<ModelLoader::Vertex *>(ModelLoader::mapBuffer(model_data->vbo, sizeof(ModelLoader::Vertex) * vertex_capacity));
+    }
+
+    // Element buffer
+    mapped_index = static_cast<GLsizei *>(ModelLoader::mapBuffer(model_data->ebo, sizeof(GLsizei) * index_capacity));
+
+    // Fall back to the stocks if any buffer could not be mapped
+    if ((mapped_index == nullptr) || ((mapped_vertex == nullptr) && ((mapped_position == nullptr) || (mapped_attributes == nullptr)))) {
+        unmapBuffers();
+        deleteBuffers();
+        return false;
+    }
+
+    return true;
+}
+
+// Enlarge the mapped vertex buffers by a half keeping the stored vertices, false if they could not be mapped
+bool ModelLoader::growVertexBuffers() {
+    // Copy the stored vertices on the GPU and map only the new range
+    const std::size_t capacity = vertex_capacity + std::max(vertex_capacity / 2U, static_cast<std::size_t>(1U));
+    bool status;
+    if (mapped_vertex != nullptr) {
+        mapped_vertex = static_cast<ModelLoader::Vertex *>(ModelLoader::growBuffer(model_data->vbo, sizeof(ModelLoader::Vertex) * vertex_count, sizeof(ModelLoader::Vertex) * capacity));
+        status = mapped_vertex != nullptr;
+    }
+    else {
+        mapped_position = static_cast<glm::vec3 *>(ModelLoader::growBuffer(model_data->vbo, sizeof(glm::vec3) * vertex_count, sizeof(glm::vec3) * capacity));
+        mapped_attributes = static_cast<ModelLoader::VertexAttributes *>(ModelLoader::growBuffer(model_data->attribute_vbo, sizeof(ModelLoader::VertexAttributes) * vertex_count, sizeof(ModelLoader::VertexAttributes) * capacity));
+        status = (mapped_position != nullptr) && (mapped_attributes != nullptr);
+    }
+
+    // Keep the capacity so the overflow is reported when unmapping
+    if (!status) {
+        return false;
+    }
+
+    vertex_capacity = capacity;
+    mapped_first = vertex_count;
+    return true;
+}
+
+// Unmap the directly written buffers and shrink the vertex buffers to the stored vertices, false if the data was lost
+bool ModelLoader::unmapBuffers() {
+    // Unmap each mapped buffer
+    bool status = true;
+    if ((mapped_vertex != nullptr) || (mapped_position != nullptr)) {
+        status = ModelLoader::unmapBuffer(model_data->vbo) && status;
+    }
+
+    if (mapped_attributes != nullptr) {
+        status = ModelLoader::unmapBuffer(model_data->attribute_vbo) && status;
+    }
+
+    if (mapped_index != nullptr) {
+        status = ModelLoader::unmapBuffer(model_data->ebo) && status;
+    }
+
+    mapped_vertex = nullptr;
+    mapped_position = nullptr;
+    mapped_attributes = nullptr;
+    mapped_index = nullptr;
+
+    // The data store was lost or the file changed after the pre-scan
+    if (!status || (vertex_count > vertex_capacity) || (index_count > index_capacity)) {
+        return false;
+    }
+
+    // Shrink the vertex buffers to the stored vertices
+    if (vertex_count < vertex_capacity) {
+        if (model_data->attribute_vbo != GL_FALSE) {
+            ModelLoader::copyBuffer(model_data->vbo, sizeof(glm::vec3) * vertex_count, sizeof(glm::vec3) * vertex_count);
+            ModelLoader::copyBuffer(model_data->attribute_vbo, sizeof(ModelLoader::VertexAttributes) * vertex_count, sizeof(ModelLoader::VertexAttributes) * vertex_count);
+        }
+        else {
+            ModelLoader::copyBuffer(model_data->vbo, sizeof(ModelLoader::Vertex) * vertex_count, sizeof(ModelLoader::Vertex) * vertex_count);
+        }
+    }
+
+    return true;
+}
+
+// Delete the buffers of the model data
+void ModelLoader::deleteBuffers() {
+    glDeleteBuffers(1, &model_data->ebo);
+    glDeleteBuffers(1, &model_data->attribute_vbo);
+    glDeleteBuffers(1, &model_data->vbo);
+    model_data->ebo = GL_FALSE;
+    model_data->attribute_vbo = GL_FALSE;
+    model_data->vbo = GL_FALSE;
+}
+
+// Sample the resident set size of the process keeping the largest one
+void ModelLoader::sampleMemory() {
+    sampled_memory = std::max(sampled_memory, ModelLoader::getCurrentMemory());
+}
+
+
+// Private static methods
+
+// Get the resident set size of the process in kilobytes, negative if it is not available
+long ModelLoader::getCurrentMemory() {
+    std::ifstream file("/proc/self/status");
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.compare(0U, 6U, "VmRSS:") == 0) {
+            return std::strtol(line.c_str() + 6U, nullptr, 10);
+        }
+    }
+
+    return -1L;
+}
+
+// Create a buffer of the given size and map it for writing, null if it could not be mapped
+void *ModelLoader::mapBuffer(GLuint &buffer, const std::size_t &size) {
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STATIC_DRAW);
+    void *const data = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, GL_FALSE);
+    return data;
+}
+
+// Unmap a buffer, false if its data store was lost
+bool ModelLoader::unmapBuffer(const GLuint &buffer) {
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    const GLboolean status = glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, GL_FALSE);
+    return status != GL_FALSE;
+}
+
+// Replace a buffer by a buffer of the given size holding a copy of its first used bytes
+void ModelLoader::copyBuffer(GLuint &buffer, const std::size_t &used, const std::size_t &size) {
+    // Copy on the GPU to a buffer of the given size
+    GLuint copy = GL_FALSE;
+    glGenBuffers(1, &copy);
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, copy);
+    glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STATIC_DRAW);
+    if (used > 0U) {
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, used);
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, GL_FALSE);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, GL_FALSE);
+
+    // Replace the buffer
+    glDeleteBuffers(1, &buffer);
+    buffer = copy;
+}
+
+// Unmap a buffer, enlarge it keeping its first used bytes and map the rest for writing, null if it could not be mapped
+void *ModelLoader::growBuffer(GLuint &buffer, const std::size_t &used, const std::size_t &size) {
+    // The written bytes are lost with the data store
+    if (!ModelLoader::unmapBuffer(buffer)) {
+        return nullptr;
+    }
 
-    // Free memory
-    vertex_stock.clear();
-    index_stock.clear();
+    // Map only the new range so the copied bytes are not read back
+    ModelLoader::copyBuffer(buffer, used, size);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    void *const data = glMapBufferRange(GL_COPY_WRITE_BUFFER, used, size - used, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, GL_FALSE);
+    return data;
 }
 
+// Point an attribute of the bound vertex array object to a vertex buffer
+void ModelLoader::setAttribute(const GLuint &index, const GLint &size, const GLuint &buffer, const GLsizei &stride, const std::size_t &offset) {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glEnableVertexAttribArray(index);
+    glVertexAttribPointer(index, size, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void *>(offset));
+}
+
+// Orthogonal unit tangent of a vertex, any unit vector orthogonal to the normal if the accumulated tangent vanishes
+glm::vec3 ModelLoader::orthogonalTangent(const glm::vec3 &tangent, const glm::vec3 &normal) {
+    // Orthogonalize the accumulated tangent against the normal
+    const glm::vec3 orthogonal = tangent - normal * glm::dot(normal, tangent);
+    const float length = glm::dot(orthogonal, orthogonal);
+    if (length > ModelLoader::TANGENT_EPSILON) {
+        return orthogonal / std::sqrt(length);
+    }
+
+    // Cross the normal with the axis least aligned to it
+    const glm::vec3 axis = std::abs(normal.x) < 0.9F ? glm::vec3(1.0F, 0.0F, 0.0F) : glm::vec3(0.0F, 1.0F, 0.0F);
+    const glm::vec3 cross = glm::cross(normal, axis);
+    const float cross_length = glm::dot(cross, cross);
+    return cross_length > ModelLoader::TANGENT_EPSILON ? cross / std::sqrt(cross_length) : glm::vec3(1.0F, 0.0F, 0.0F);
+}
+
+// Accumulate the tangents of the triangles in parallel and orthogonalize them against the normals
+void ModelLoader::calcTangents(const std::vector<ModelLoader::Vertex> &vertex, const std::vector<GLsizei> &index, std::vector<glm::vec3> &tangent) {
+    PROFILE_ZONE("ModelLoader::calcTangents");
+
+    // Split the triangles in a chunk per thread, each one accumulating in its own buffer to avoid the concurrent writes, as many as the memory bound allows
+    const std::size_t triangles = index.size() / 3U;
+    const std::size_t vertices = vertex.size();
+    const std::size_t buffers = 1U + ModelLoader::TANGENT_MEMORY / std::max<std::size_t>(sizeof(glm::vec3) * vertices, 1U);
+    const std::size_t chunks = std::max<std::size_t>(std::min<std::size_t>(std::min<std::size_t>(static_cast<std::size_t>(JobSystem::getThreads()), triangles / 16384U), buffers), 1U);
+    tangent.assign(vertices, glm::vec3(0.0F));
+    std::vector<glm::vec3> partial((chunks - 1U) * vertices, glm::vec3(0.0F));
+
+    // Accumulate the tangent of each triangle, the first chunk directly in the result
+    JobSystem::parallelFor(chunks, 1U, [&vertex, &index, &tangent, &partial, &triangles, &vertices, &chunks] (const std::size_t &begin, const std::size_t &end) {
+        for (std::size_t chunk = begin; chunk < end; chunk++) {
+            glm::vec3 *const accumulated = chunk == 0U ? &tangent[0] : &partial[(chunk - 1U) * vertices];
+            const std::size_t last = (chunk + 1U) * triangles / chunks * 3U;
+            for (std::size_t i = chunk * triangles / chunks * 3U; i < last; i += 3U) {
+                // Get vertices
+                const ModelLoader::Vertex &vertex_0 = vertex[static_cast<std::size_t>(index[i])];
+                const ModelLoader::Vertex &vertex_1 = vertex[static_cast<std::size_t>(index[i + 1U])];
+                const ModelLoader::Vertex &vertex_2 = vertex[static_cast<std::size_t>(index[i + 2U])];
+
+                // Get texture triangle edges, the degenerate mappings have no tangent
+                const glm::vec2 d0(vertex_1.uv_coord - vertex_0.uv_coord);
+                const glm::vec2 d1(vertex_2.uv_coord - vertex_0.uv_coord);
+                const float determinant = std::abs(d0.s * d1.t - d1.s * d0.t);
+                if (!(determinant > ModelLoader::TANGENT_EPSILON)) {
+                    continue;
+                }
+
+                // Get position triangle edges and calculate the tangent
+                const glm::vec3 l0(vertex_1.position - vertex_0.position);
+                const glm::vec3 l1(vertex_2.position - vertex_0.position);
+                const glm::vec3 triangle_tangent((l0 * d1.t - l1 * d0.t) / determinant);
+
+                // Accumulate tangent
+                accumulated[index[i]] += triangle_tangent;
+                accumulated[index[i + 1U]] += triangle_tangent;
+                accumulated[index[i + 2U]] += triangle_tangent;
+            }
+        }
+    });
+
+    // Sum the chunks buffers, orthogonalize the tangents against the normals and normalize them
+    JobSystem::parallelFor(vertices, 4096U, [&vertex, &tangent, &partial, &vertices, &chunks] (const std::size_t &begin, const std::size_t &end) {
+        for (std::size_t i = begin; i < end; i++) {
+            for (std::size_t chunk = 1U; chunk < chunks; chunk++) {
+                tangent[i] += partial[(chunk - 1U) * vertices + i];
+            }
+        }
+
+        std::size_t i = begin;
+#if defined(__SSE__)
+        // Four vertices at once
+        const __m128 epsilon = _mm_set1_ps(ModelLoader::TANGENT_EPSILON);
+        const __m128 half = _mm_set1_ps(0.5F);
+        const __m128 three_halves = _mm_set1_ps(1.5F);
+        for (; i + 4U <= end; i += 4U) {
+            const glm::vec3 *const t = &tangent[i];
+            const ModelLoader::Vertex *const v = &vertex[i];
+            const __m128 tx = _mm_set_ps(t[3].x, t[2].x, t[1].x, t[0].x);
+            const __m128 ty = _mm_set_ps(t[3].y, t[2].y, t[1].y, t[0].y);
+            const __m128 tz = _mm_set_ps(t[3].z, t[2].z, t[1].z, t[0].z);
+            const __m128 nx = _mm_set_ps(v[3].normal.x, v[2].normal.x, v[1].normal.x, v[0].normal.x);
+            const __m128 ny = _mm_set_ps(v[3].normal.y, v[2].normal.y, v[1].normal.y, v[0].normal.y);
+            const __m128 nz = _mm_set_ps(v[3].normal.z, v[2].normal.z, v[1].normal.z, v[0].normal.z);
+
+            // Remove the normal component
+            const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, tx), _mm_mul_ps(ny, ty)), _mm_mul_ps(nz, tz));
+            const __m128 ox = _mm_sub_ps(tx, _mm_mul_ps(nx, dot));
+            const __m128 oy = _mm_sub_ps(ty, _mm_mul_ps(ny, dot));
+            const __m128 oz = _mm_sub_ps(tz, _mm_mul_ps(nz, dot));
+
+            // Reciprocal square root refined with a Newton step
+            const __m128 length = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ox, ox), _mm_mul_ps(oy, oy)), _mm_mul_ps(oz, oz));
+            __m128 inverse = _mm_rsqrt_ps(length);
+            inverse = _mm_mul_ps(inverse, _mm_sub_ps(three_halves, _mm_mul_ps(_mm_mul_ps(half, length), _mm_mul_ps(inverse, inverse))));
+            const int valid = _mm_movemask_ps(_mm_cmpgt_ps(length, epsilon));
+
+            float x[4];
+            float y[4];
+            float z[4];
+            _mm_storeu_ps(x, _mm_mul_ps(ox, inverse));
+            _mm_storeu_ps(y, _mm_mul_ps(oy, inverse));
+            _mm_storeu_ps(z, _mm_mul_ps(oz, inverse));
+
+            // The vanished tangents take the scalar fallback
+            for (int j = 0; j < 4; j++) {
+                tangent[i + static_cast<std::size_t>(j)] = (valid & (1 << j)) != 0 ? glm::vec3(x[j], y[j], z[j]) : ModelLoader::orthogonalTangent(t[j], v[j].normal);
+            }
+        }
+#endif
+
+        // A vertex at once
+        for (; i < end; i++) {
+            tangent[i] = ModelLoader::orthogonalTangent(tangent[i], vertex[i].normal);
+        }
+    });
+}
 
 // Destructor
 
@@ -81,6 +599,20 @@ ModelLoader::~ModelLoader() {}
 
 // Read and load data
 ModelData *ModelLoader::load(const std::string &path, const ModelLoader::Format &format) {
+    // Read data directly into the buffers, this is the OpenGL thread
+    ModelLoader *loader = ModelLoader::read(path, format, true);
+
+    // Return empty model data if the format is unknown
+    if (loader == nullptr) {
+        return new ModelData(path);
+    }
+
+    // Load data
+    return ModelLoader::upload(loader);
+}
+
+// Read data without OpenGL calls and safe to call from worker threads, or directly into mapped buffers from the OpenGL thread
+ModelLoader *ModelLoader::read(const std::string &path, const ModelLoader::Format &format, const bool &direct) {
     // Create a null model loader
     ModelLoader *loader = nullptr;
 
@@ -88,19 +620,39 @@ ModelData *ModelLoader::load(const std::string &path, const ModelLoader::Format
     switch (format) {
         case OBJ: loader = static_cast<ModelLoader *>(new OBJLoader(path)); break;
 
-        // Return empty model data if the format is unknown
+        // Return null if the format is unknown
         default:
             std::cerr << "error: unknown model loader format `" << format << "'" << std::endl;
-            return new ModelData(path);
+            return nullptr;
     }
 
-    // Read and load data
-    if (loader->read()) {
+    // Read data sampling the memory growth from here, without resetting the process peak shared with the concurrent loads
+    loader->start_memory = ModelLoader::getCurrentMemory();
+    loader->sampled_memory = loader->start_memory;
+    loader->direct = direct;
+    loader->read();
+
+    // Return the loader
+    return loader;
+}
+
+// Load the read data and textures to GPU and delete the loader
+ModelData *ModelLoader::upload(ModelLoader *const loader) {
+    // Load data
+    if (loader->model_data->model_open) {
         loader->load();
     }
 
-    // Get the model data and delete loader
+    // Decode the deferred textures in parallel and upload them
+    Material::decodeTextures(loader->model_data->material_stock);
+    loader->sampleMemory();
+    for (Material *const material : loader->model_data->material_stock) {
+        material->loadTextures();
+    }
+
+    // Get the model data with the memory growth sampled during the load and delete loader
     ModelData *model_data = loader->model_data;
+    model_data->load_memory = std::max(loader->sampled_memory - loader->start_memory, 0L);
     delete loader;
 
     // Return the model data
@@ -124,6 +676,10 @@ std::vector<Material *> ModelLoader::loadMaterial(const std::string &path, const
 
     // Read and load the material data
     loader->readMaterial(path);
+    Material::decodeTextures(loader->model_data->material_stock);
+    for (Material *const material : loader->model_data->material_stock) {
+        material->loadTextures();
+    }
 
     // Get the material data
     std::vector<Material *> material_stock(loader->model_data->material_stock);
@@ -137,8 +693,72 @@ std::vector<Material *> ModelLoader::loadMaterial(const std::string &path, const
     return material_stock;
 }
 
+// Generate the tangents of the loaded data reading back its buffers and load them to GPU, false if there is no data
+bool ModelLoader::loadTangents(ModelData *const model_data) {
+    PROFILE_ZONE("ModelLoader::loadTangents");
+
+    // Check the loaded data
+    if ((model_data->vao == GL_FALSE) || (model_data->elements == 0U) || (model_data->triangles == 0U)) {
+        return false;
+    }
+
+    // Read back the vertices, gathering the streams of the split layout
+    std::vector<ModelLoader::Vertex> vertex(model_data->elements);
+    if (model_data->attribute_vbo != GL_FALSE) {
+        std::vector<glm::vec3> position(model_data->elements);
+        std::vector<ModelLoader::VertexAttributes> attributes(model_data->elements);
+        glBindBuffer(GL_COPY_READ_BUFFER, model_data->vbo);
+        glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(glm::vec3) * position.size(), &position[0]);
+        glBindBuffer(GL_COPY_READ_BUFFER, model_data->attribute_vbo);
+        glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(ModelLoader::VertexAttributes) * attributes.size(), &attributes[0]);
+
+        for (std::size_t i = 0U; i < vertex.size(); i++) {
+            vertex[i].position = position[i];
+            vertex[i].uv_coord = attributes[i].uv_coord;
+            vertex[i].normal = attributes[i].normal;
+        }
+    }
+    else {
+        glBindBuffer(GL_COPY_READ_BUFFER, model_data->vbo);
+        glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(ModelLoader::Vertex) * vertex.size(), &vertex[0]);
+    }
+
+    // Read back the indices
+    std::vector<GLsizei> index(model_data->triangles * 3U);
+    glBindBuffer(GL_COPY_READ_BUFFER, model_data->ebo);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(GLsizei) * index.size(), &index[0]);
+    glBindBuffer(GL_COPY_READ_BUFFER, GL_FALSE);
+
+    // Calculate the tangents
+    std::vector<glm::vec3> tangent;
+    ModelLoader::calcTangents(vertex, index, tangent);
+
+    // Tangents vertex buffer object
+    glGenBuffers(1, &model_data->tangent_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, model_data->tangent_vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * tangent.size(), &tangent[0], GL_STATIC_DRAW);
+
+    // Attach the tangent attribute to the full vertex array object
+    glBindVertexArray(model_data->vao);
+    ModelLoader::setAttribute(3, 3, model_data->tangent_vbo, sizeof(glm::vec3), 0U);
+    glBindVertexArray(GL_FALSE);
+
+    return true;
+}
+
 
 // Right std::string trim
 void ModelLoader::rtrim(std::string &str) {
     str.erase(str.find_last_not_of(ModelLoader::space) + 1);
+}
+
+
+// Get the vertex buffers layout of the next uploads
+ModelLoader::Layout ModelLoader::getVertexLayout() {
+    return ModelLoader::vertex_layout;
+}
+
+// Set the vertex buffers layout of the next uploads
+void ModelLoader::setVertexLayout(const ModelLoader::Layout &layout) {
+    ModelLoader::vertex_layout = layout;
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef __MODEL_LOADER_HPP_
 #define __MODEL_LOADER_HPP_
 
+#include "arena.hpp"
 #include "modeldata.hpp"
 #include "../material.hpp"
 
@@ -9,12 +10,32 @@
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
+#include <string>
+
 #include <map>
 #include <vector>
 
 
 /** Model loader abstract class */
 class ModelLoader {
+    public:
+        // Enumerations
+
+        /** Formats */
+        enum Format {
+            OBJ
+        };
+
+        /** Vertex buffers layouts */
+        enum Layout {
+            /** Position, texture coordinate, normal and tangent interleaved in one buffer */
+            INTERLEAVED,
+
+            /** Tightly packed positions in one buffer and the rest of the attributes in another */
+            SPLIT
+        };
+
+
     protected:
         // Structs
 
@@ -32,9 +53,6 @@ class ModelLoader {
                 /** Normal vector */
                 glm::vec3 normal;
 
-                /** Tangent vector */
-                glm::vec3 tangent;
-
 
                 // Constructor
 
@@ -42,6 +60,75 @@ class ModelLoader {
                 Vertex();
         };
 
+        /** Vertex attributes except the position, stored apart in the split layout */
+        struct VertexAttributes {
+            public:
+                // Attributes
+
+                /** Texture coordinate */
+                glm::vec2 uv_coord;
+
+                /** Normal vector */
+                glm::vec3 normal;
+        };
+
+        /** Token view into the read line or the arena, without the null terminator */
+        struct Token {
+            public:
+                // Attributes
+
+                /** First character */
+                const char *data;
+
+                /** Number of characters */
+                std::size_t size;
+
+
+                // Constructor
+
+                /** Token constructor */
+                Token(const char *const data, const std::size_t &size);
+        };
+
+        /** Occluder candidate triangle */
+        struct OccluderTriangle {
+            public:
+                // Attributes
+
+                /** Twice the triangle area */
+                float area;
+
+                /** Vertices positions */
+                glm::vec3 position[3];
+
+                /** Object index, the triangles before the first object belong to it */
+                std::size_t object;
+        };
+
+        /** Lexicographical order of the tokens */
+        struct TokenLess {
+            public:
+                // Operators
+
+                /** Less than comparison */
+                bool operator()(const ModelLoader::Token &a, const ModelLoader::Token &b) const;
+        };
+
+        /** Larger area order of the occluder triangles, a min heap by area with the heap algorithms */
+        struct OccluderLarger {
+            public:
+                // Operators
+
+                /** Greater than comparison */
+                bool operator()(const ModelLoader::OccluderTriangle &a, const ModelLoader::OccluderTriangle &b) const;
+        };
+
+
+        // Types
+
+        /** Parsed vertices map allocated in the arena */
+        typedef std::map<ModelLoader::Token, GLsizei, ModelLoader::TokenLess, ArenaAllocator<std::pair<const ModelLoader::Token, GLsizei> > > VertexMap;
+
 
         // Attributes
 
@@ -58,16 +145,67 @@ class ModelLoader {
         std::vector<glm::vec3> normal_stock;
 
 
-        /** Parsed vertices */
-        std::map<std::string, GLsizei> parsed_vertex;
+        /** Parse time temporaries released at once after the read */
+        Arena arena;
 
-        /** Indices */
+        /** Parsed vertices with the keys in the arena */
+        ModelLoader::VertexMap parsed_vertex;
+
+        /** Indices, unused if they are written directly */
         std::vector<GLsizei> index_stock;
 
-        /** Vertices */
+        /** Vertices, unused if they are written directly */
         std::vector<Vertex> vertex_stock;
 
 
+        /** Largest triangles found so far in a min heap by area */
+        std::vector<ModelLoader::OccluderTriangle> occluder_heap;
+
+        /** Minimum position values of the triangles stored before the first object */
+        glm::vec3 unassigned_min;
+
+        /** Maximum position values of the triangles stored before the first object */
+        glm::vec3 unassigned_max;
+
+
+        /** Write the vertices and indices directly into the mapped buffers, only from the OpenGL thread */
+        bool direct;
+
+        /** Capacity of the mapped vertex buffers, starting at the lower bound of the unique vertices from the pre-scan */
+        std::size_t vertex_capacity;
+
+        /** Number of indices from the pre-scan */
+        std::size_t index_capacity;
+
+        /** Number of stored vertices */
+        std::size_t vertex_count;
+
+        /** Number of stored indices */
+        std::size_t index_count;
+
+        /** First vertex of the mapped range of the vertex buffers */
+        std::size_t mapped_first;
+
+        /** Mapped interleaved vertex buffer */
+        ModelLoader::Vertex *mapped_vertex;
+
+        /** Mapped positions buffer of the split layout */
+        glm::vec3 *mapped_position;
+
+        /** Mapped attributes buffer of the split layout */
+        ModelLoader::VertexAttributes *mapped_attributes;
+
+        /** Mapped element buffer */
+        GLsizei *mapped_index;
+
+
+        /** Resident set size of the process when the read started in kilobytes */
+        long start_memory;
+
+        /** Largest resident set size of the process sampled during the load in kilobytes */
+        long sampled_memory;
+
+
         // Constructors
 
         /** Model loader constructor */
@@ -91,24 +229,97 @@ class ModelLoader {
         /** Read material data from file */
         virtual bool readMaterial(const std::string &path) = 0;
 
+        /** Upload the vertex and index stocks to new buffers, the split streams are gathered in chunks */
+        void uploadBuffers();
+
         /** Load data to GPU */
         void load();
 
 
+        /** Update the position limits with a vertex position */
+        void updateLimits(const glm::vec3 &position);
+
+        /** Store a new vertex in the mapped buffers or in the vertex stock */
+        void pushVertex(const ModelLoader::Vertex &vertex);
+
+        /** Store an index in the mapped buffer or in the index stock */
+        void pushIndex(const GLsizei &index);
+
+        /** Update the current object bounds and the occluder candidates with a triangle */
+        void addTriangle(const glm::vec3 &position_0, const glm::vec3 &position_1, const glm::vec3 &position_2);
+
+        /** Keep the largest triangles as occluder */
+        void buildOccluder();
+
+
+        /** Create and map the buffers from the pre-scan sizes, false if they could not be mapped and the stocks are used instead */
+        bool mapBuffers();
+
+        /** Enlarge the mapped vertex buffers by a half keeping the stored vertices, false if they could not be mapped */
+        bool growVertexBuffers();
+
+        /** Unmap the directly written buffers and shrink the vertex buffers to the stored vertices, false if the data was lost */
+        bool unmapBuffers();
+
+        /** Delete the buffers of the model data */
+        void deleteBuffers();
+
+        /** Sample the resident set size of the process keeping the largest one */
+        void sampleMemory();
+
+
         // Static attributes
 
         /** Space characters */
         static const std::string space;
 
-    public:
-        // Enumerations
+        /** Vertex buffers layout of the next uploads */
+        static ModelLoader::Layout vertex_layout;
 
-        /** Formats */
-        enum Format {
-            OBJ
-        };
 
+        // Static const attributes
+
+        /** Maximum number of occluder triangles */
+        static const std::size_t OCCLUDER_TRIANGLES = 512U;
+
+        /** Smallest texture mapping area and squared tangent length taken as non degenerate */
+        static const float TANGENT_EPSILON;
+
+        /** Memory bound of the extra tangent accumulation buffers of the threads in bytes */
+        static const std::size_t TANGENT_MEMORY = 64U << 20U;
+
+        /** Vertices per gathered chunk of the split uploads */
+        static const std::size_t UPLOAD_CHUNK = 65536U;
+
+
+        // Static methods
+
+        /** Point an attribute of the bound vertex array object to a vertex buffer */
+        static void setAttribute(const GLuint &index, const GLint &size, const GLuint &buffer, const GLsizei &stride, const std::size_t &offset);
+
+        /** Get the resident set size of the process in kilobytes, negative if it is not available */
+        static long getCurrentMemory();
 
+        /** Create a buffer of the given size and map it for writing, null if it could not be mapped */
+        static void *mapBuffer(GLuint &buffer, const std::size_t &size);
+
+        /** Unmap a buffer, false if its data store was lost */
+        static bool unmapBuffer(const GLuint &buffer);
+
+        /** Replace a buffer by a buffer of the given size holding a copy of its first used bytes */
+        static void copyBuffer(GLuint &buffer, const std::size_t &used, const std::size_t &size);
+
+        /** Unmap a buffer, enlarge it keeping its first used bytes and map the rest for writing, null if it could not be mapped */
+        static void *growBuffer(GLuint &buffer, const std::size_t &used, const std::size_t &size);
+
+        /** Orthogonal unit tangent of a vertex, any unit vector orthogonal to the normal if the accumulated tangent vanishes */
+        static glm::vec3 orthogonalTangent(const glm::vec3 &tangent, const glm::vec3 &normal);
+
+        /** Accumulate the tangents of the triangles in parallel and orthogonalize them against the normals */
+        static void calcTangents(const std::vector<ModelLoader::Vertex> &vertex, const std::vector<GLsizei> &index, std::vector<glm::vec3> &tangent);
+
+
+    public:
         // Destructor
 
         /** Virtual model loader destructor */
@@ -120,12 +331,28 @@ class ModelLoader {
         /** Read and load data */
         static ModelData *load(const std::string &path, const ModelLoader::Format &format);
 
+        /** Read data without OpenGL calls and safe to call from worker threads, or directly into mapped buffers from the OpenGL thread */
+        static ModelLoader *read(const std::string &path, const ModelLoader::Format &format, const bool &direct = false);
+
+        /** Load the read data and textures to GPU and delete the loader */
+        static ModelData *upload(ModelLoader *const loader);
+
         /** Read and load the material data */
         static std::vector<Material *> loadMaterial(const std::string &path, const ModelLoader::Format &format);
 
+        /** Generate the tangents of the loaded data reading back its buffers and load them to GPU, false if there is no data */
+        static bool loadTangents(ModelData *const model_data);
+
 
         /** Right std::string trim */
         static void rtrim(std::string &str);
+
+
+        /** Get the vertex buffers layout of the next uploads */
+        static ModelLoader::Layout getVertexLayout();
+
+        /** Set the vertex buffers layout of the next uploads */
+        static void setVertexLayout(const ModelLoader::Layout &layout);
 };
 
 #endif // __MODEL_LOADER_HPP_
\ No newline at end of file
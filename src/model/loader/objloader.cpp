@@ -1,5 +1,6 @@
 #include "objloader.hpp"
 
+#include "../../profiler/profiler.hpp"
 #include "../../dirsep.h"
 
 #include "../../glad/glad.h"
@@ -12,6 +13,8 @@
 #include <vector>
 
 #include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -19,14 +22,109 @@
 
 // Private methods
 
+// Count the attributes and the triangulated face indices with a fast scan, reserve the stocks and set the mapped buffers sizes, false if the file could not be open
+bool OBJLoader::scan() {
+    PROFILE_ZONE("OBJLoader::scan");
+
+    // Open the model file in binary mode to read it in blocks
+    std::ifstream file(model_data->model_path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // Line kind from the first token, the column and the face vertices of the current line
+    std::size_t positions = 0U;
+    std::size_t uv_coords = 0U;
+    std::size_t normals = 0U;
+    std::size_t indices = 0U;
+    char kind = '\0';
+    std::size_t column = 0U;
+    std::size_t face_vertices = 0U;
+    bool in_token = false;
+
+    // Scan the file in blocks, the lines may cross them
+    std::vector<char> block(1U << 20U);
+    do {
+        file.read(&block[0], static_cast<std::streamsize>(block.size()));
+        const std::size_t size = static_cast<std::size_t>(file.gcount());
+        for (std::size_t i = 0U; i <= size; i++) {
+            // Count the finished line, the last one may not have a line break
+            const bool last = (i == size) && (size < block.size());
+            if (last || ((i < size) && (block[i] == '\n'))) {
+                switch (kind) {
+                    case 'v': positions++; break;
+                    case 't': uv_coords++; break;
+                    case 'n': normals++; break;
+                    case 'f':
+                        indices += face_vertices > 2U ? 3U * (face_vertices - 2U) : 0U;
+                }
+
+                kind = '\0';
+                column = 0U;
+                face_vertices = 0U;
+                in_token = false;
+                continue;
+            }
+            else if (i == size) {
+                break;
+            }
+
+            // Classify the line by its first token, skipping the leading spaces
+            const char character = block[i];
+            const bool space = std::isspace(static_cast<unsigned char>(character)) != 0;
+            if ((column == 0U) && space) {
+                continue;
+            }
+            else if (column == 0U) {
+                kind = (character == 'v') || (character == 'f') ? character : '\0';
+            }
+            else if ((column == 1U) && (kind == 'v')) {
+                kind = space ? 'v' : (character == 't') || (character == 'n') ? character : '\0';
+            }
+            else if ((column == 1U) && (kind == 'f')) {
+                kind = space ? 'f' : '\0';
+            }
+            else if ((column == 2U) && ((kind == 't') || (kind == 'n')) && !space) {
+                kind = '\0';
+            }
+
+            // Count the face vertices tokens
+            else if (kind == 'f') {
+                face_vertices += !space && !in_token;
+                in_token = !space;
+            }
+
+            column++;
+        }
+    } while (file.gcount() == static_cast<std::streamsize>(block.size()));
+
+    // Reserve the exact attribute stocks
+    position_stock.reserve(positions);
+    uv_coord_stock.reserve(uv_coords);
+    normal_stock.reserve(normals);
+
+    // The unique vertices are at least as many as the most numerous attribute, the mapped vertex buffers grow from there
+    const std::size_t vertices = std::min(indices, std::max(positions, std::max(uv_coords, normals)));
+    vertex_capacity = vertices;
+    index_capacity = indices;
+
+    // Reserve the vertex and index stocks if they are not written directly
+    if (!direct) {
+        index_stock.reserve(indices);
+        vertex_stock.reserve(vertices);
+    }
+
+    return true;
+}
+
 // Parse, store the vertex and returns its index
-GLsizei OBJLoader::storeVertex(const std::string &vertex_str) {
+GLsizei OBJLoader::storeVertex(const char *const vertex_str, const std::size_t &size) {
     // Search the vertex
-    std::map<std::string, GLsizei>::iterator result = parsed_vertex.find(vertex_str);
+    ModelLoader::VertexMap::iterator result = parsed_vertex.find(ModelLoader::Token(vertex_str, size));
 
     // Return the index of already parsed vertex
     if (result != parsed_vertex.end()) {
-        index_stock.emplace_back(result->second);
+        pushIndex(result->second);
         return result->second;
     }
 
@@ -35,56 +133,39 @@ GLsizei OBJLoader::storeVertex(const std::string &vertex_str) {
     ModelLoader::Vertex vertex;
 
     // Parse vertex indices data
-    for (std::size_t i = 0, begin = 0, end = 0; (i < 3) && (end != std::string::npos); i++, begin = end + 1) {
+    const char *const end = vertex_str + size;
+    const char *begin = vertex_str;
+    for (int i = 0; (i < 3) && (begin < end); i++) {
         // Find next attribute position
-        end = vertex_str.find('/', begin);
+        const char *const slash = std::find(begin, end, '/');
 
         // Parse index and get attribute
-        if ((begin < vertex_str.size()) && (begin < end)) {
+        if (begin < slash) {
+            const long index = std::strtol(begin, nullptr, 10) - 1;
             switch (i) {
-                case 0: vertex.position = position_stock[std::stoi(vertex_str.substr(begin)) - 1]; break;
-                case 1: vertex.uv_coord = uv_coord_stock[std::stoi(vertex_str.substr(begin)) - 1]; break;
-                case 2: vertex.normal   = normal_stock[std::stoi(vertex_str.substr(begin)) - 1];
+                case 0: vertex.position = position_stock[index]; break;
+                case 1: vertex.uv_coord = uv_coord_stock[index]; break;
+                case 2: vertex.normal   = normal_stock[index];
             }
         }
+
+        begin = slash + 1;
     }
 
-    // Add vertex
-    GLsizei index = static_cast<GLsizei>(vertex_stock.size());
-    parsed_vertex[vertex_str] = index;
-    index_stock.emplace_back(index);
-    vertex_stock.emplace_back(vertex);
+    // Add vertex with its key copied to the arena
+    GLsizei index = static_cast<GLsizei>(vertex_count);
+    parsed_vertex.emplace(ModelLoader::Token(arena.copy(vertex_str, size), size), index);
+    pushIndex(index);
+    pushVertex(vertex);
 
     // Return the index
     return index;
 }
 
-// Calculate the tangent vector for each vertex of a triangle
-void OBJLoader::calcTangent(const GLsizei &ind_0, const GLsizei &ind_1, const GLsizei &ind_2) {
-    // Get vertices
-    ModelLoader::Vertex &vertex_0 = vertex_stock.at(ind_0);
-    ModelLoader::Vertex &vertex_1 = vertex_stock.at(ind_1);
-    ModelLoader::Vertex &vertex_2 = vertex_stock.at(ind_2);
-
-    // Get position triangle edges
-    const glm::vec3 l0(vertex_1.position - vertex_0.position);
-    const glm::vec3 l1(vertex_2.position - vertex_0.position);
-
-    // Get texture triangle edges
-    const glm::vec2 d0(vertex_1.uv_coord - vertex_0.uv_coord);
-    const glm::vec2 d1(vertex_2.uv_coord - vertex_0.uv_coord);
-
-    // Calculate tangent
-    const glm::vec3 tangent((l0 * d1.t - l1 * d0.t) / glm::abs(d0.s * d1.t - d1.s * d0.t));
-
-    // Accumulate tangent
-    vertex_0.tangent += tangent;
-    vertex_1.tangent += tangent;
-    vertex_2.tangent += tangent;
-}
-
 // Read data from file
 bool OBJLoader::read() {
+    PROFILE_ZONE("OBJLoader::read");
+
     // Open the model file and check it
     std::ifstream file(model_data->model_path);
     if (!file.is_open()) {
@@ -92,13 +173,20 @@ bool OBJLoader::read() {
         return false;
     }
 
-    // Model read variables
-    std::vector<std::string> face;
-    std::string token;
+    // Reserve the stocks and write directly into the mapped buffers if they could be mapped
+    direct = scan() && direct && mapBuffers();
+
+    // Model read variables, the tokens point into the line to avoid copies
+    std::vector<ModelLoader::Token> face;
+    std::vector<glm::vec3> face_position;
     std::string line;
+    char *next;
     glm::vec3 data;
     GLsizei count = 0U;
 
+    // Faces vertices profiling batch
+    Profiler::Batch face_batch("OBJLoader::storeVertex");
+
     // Read the file
     while(!file.eof()) {
         // Read line
@@ -115,113 +203,130 @@ bool OBJLoader::read() {
             continue;
         }
 
-        // Create a string stream and read the first token
-        std::istringstream stream(line);
-        stream >> token;
+        // Split the left trimmed first token and arguments, the right trimmed line is not empty nor blank
+        const std::size_t token_start = line.find_first_not_of(ModelLoader::space);
+        const std::size_t token_end = std::min(line.find_first_of(ModelLoader::space, token_start), line.size());
+        const std::size_t token_size = token_end - token_start;
+        const char *const arguments = line.c_str() + std::min(line.find_first_not_of(ModelLoader::space, token_end), line.size());
 
         // Load material file
-        if (token == "mtllib") {
-            // Get the relative path to the material file
-            stream >> std::ws;
-            std::getline(stream, token);
-
-            // Read mtl file
-            readMaterial(model_data->model_path.substr(0U, model_data->model_path.find_last_of(DIR_SEP) + 1U) + token);
+        if (line.compare(token_start, token_size, "mtllib") == 0) {
+            // Read mtl file with the relative path
+            readMaterial(model_data->model_path.substr(0U, model_data->model_path.find_last_of(DIR_SEP) + 1U) + arguments);
         }
 
         // Use material for the next vertices
-        else if ((token == "usemtl") && model_data->material_open) {
+        else if ((line.compare(token_start, token_size, "usemtl") == 0) && model_data->material_open) {
             // Set count to the previous object
             if (!model_data->object_stock.empty()) {
-                model_data->object_stock.back()->count = static_cast<GLsizei>(index_stock.size()) - count;
-                count = static_cast<GLsizei>(index_stock.size());
+                model_data->object_stock.back().count = static_cast<GLsizei>(index_count) - count;
+                count = static_cast<GLsizei>(index_count);
             }
 
-            // Read material name
-            stream >> std::ws;
-            std::getline(stream, token);
-
-            // Search in the stock
-            for (Material *const material : model_data->material_stock) {
-                if (material->getName() == token) {
-                    model_data->object_stock.emplace_back(new ModelData::Object(0, count, material));
+            // Search the material name in the stock
+            for (std::size_t i = 0U; i < model_data->material_stock.size(); i++) {
+                if (model_data->material_stock[i]->getName() == arguments) {
+                    model_data->object_stock.emplace_back(0, count, i);
                     break;
                 }
             }
         }
 
         // Store vertex position
-        else if (token == "v") {
-            stream >> data.x >> data.y >> data.z;
+        else if (line.compare(token_start, token_size, "v") == 0) {
+            data.x = std::strtof(arguments, &next);
+            data.y = std::strtof(next, &next);
+            data.z = std::strtof(next, &next);
             position_stock.emplace_back(data);
 
             // Update the position limits
-            if (data.x < model_data->min.x) model_data->min.x = data.x;
-            if (data.y < model_data->min.y) model_data->min.y = data.y;
-            if (data.z < model_data->min.z) model_data->min.z = data.z;
-            if (data.x > model_data->max.x) model_data->max.x = data.x;
-            if (data.y > model_data->max.y) model_data->max.y = data.y;
-            if (data.z > model_data->max.z) model_data->max.z = data.z;
+            updateLimits(data);
         }
 
         // Store normal
-        else if (token == "vn") {
-            stream >> data.x >> data.y >> data.z;
+        else if (line.compare(token_start, token_size, "vn") == 0) {
+            data.x = std::strtof(arguments, &next);
+            data.y = std::strtof(next, &next);
+            data.z = std::strtof(next, &next);
             normal_stock.emplace_back(data);
         }
 
         // Store texture coordinate
-        else if (token == "vt") {
-            stream >> data.x >> data.y;
+        else if (line.compare(token_start, token_size, "vt") == 0) {
+            data.x = std::strtof(arguments, &next);
+            data.y = std::strtof(next, &next);
             uv_coord_stock.emplace_back(glm::vec2(data));
         }
 
         // Store face
-        else if (token == "f") {
-            // Read the face vertex data
-            while (stream >> token) {
-                face.emplace_back(token);
+        else if (line.compare(token_start, token_size, "f") == 0) {
+            // Split the face vertex data
+            for (const char *token = arguments; *token != '\0'; token += std::strspn(token, ModelLoader::space.c_str())) {
+                const std::size_t size = std::strcspn(token, ModelLoader::space.c_str());
+                face.emplace_back(token, size);
+                token += size;
             }
 
-            // First vertex
-            const std::string &first = *face.begin();
+            // Face vertices positions for the objects bounds and the occluder
+            for (const ModelLoader::Token &vertex : face) {
+                face_position.emplace_back(position_stock[std::strtol(vertex.data, nullptr, 10) - 1]);
+            }
 
             // Triangulate polygon
-            for (std::vector<std::string>::iterator it = face.begin() + 2; it != face.end(); it++) {
-                // Store the first and previous vertex
-                const GLsizei ind_0 = storeVertex(first);
-                const GLsizei ind_1 = storeVertex(*(it - 1));
-
-                // Store the current vertex
-                const GLsizei ind_2 = storeVertex(*it);
-
-                // Calculate the tangent of the triangle
-                calcTangent(ind_0, ind_1, ind_2);
+            face_batch.begin();
+            for (std::size_t i = 2U; i < face.size(); i++) {
+                // Store the first, previous and current vertex
+                storeVertex(face[0U].data, face[0U].size);
+                storeVertex(face[i - 1U].data, face[i - 1U].size);
+                storeVertex(face[i].data, face[i].size);
+                addTriangle(face_position[0U], face_position[i - 1U], face_position[i]);
             }
+            face_batch.end();
 
-            // Clear faces vector
+            // Clear faces vectors
             face.clear();
+            face_position.clear();
         }
     }
 
     // Close file
     file.close();
+    face_batch.flush();
 
     // Set count to the last object
     if (model_data->material_open) {
-        model_data->object_stock.back()->count = static_cast<GLsizei>(index_stock.size()) - count;
+        model_data->object_stock.back().count = static_cast<GLsizei>(index_count) - count;
     }
 
     // Create a default material and associate all vertices to it if the material file could not be open
     else {
-        Material *material = new Material("default");
-        model_data->material_stock.emplace_back(material);
-        model_data->object_stock.emplace_back(new ModelData::Object(static_cast<GLsizei>(index_stock.size()), 0, material));
+        model_data->material_stock.emplace_back(new Material("default"));
+        model_data->object_stock.emplace_back(static_cast<GLsizei>(index_count), 0, model_data->material_stock.size() - 1U);
+    }
+
+    // The triangles before the first material are drawn with the first object
+    if (!model_data->object_stock.empty()) {
+        model_data->object_stock.front().min = glm::min(model_data->object_stock.front().min, unassigned_min);
+        model_data->object_stock.front().max = glm::max(model_data->object_stock.front().max, unassigned_max);
     }
 
-    // Orthogonalize tangents
-    for (ModelLoader::Vertex &vertex : vertex_stock) {
-        vertex.tangent = glm::normalize(vertex.tangent - vertex.normal * glm::dot(vertex.normal, vertex.tangent));
+    // Sample the memory at the end of the parse, save the vertices statistic and free the parse memory before the post-parse stages, the parsed vertices keys live in the arena
+    sampleMemory();
+    model_data->vertices = position_stock.size();
+    parsed_vertex.clear();
+    arena.release();
+    std::vector<glm::vec3>().swap(position_stock);
+    std::vector<glm::vec2>().swap(uv_coord_stock);
+    std::vector<glm::vec3>().swap(normal_stock);
+
+    // Keep the occluder, the objects bounds were updated while parsing and the tangents wait for their first use
+    buildOccluder();
+
+    // Unmap the directly written buffers
+    if (direct && !unmapBuffers()) {
+        deleteBuffers();
+        std::cerr << "error: the buffers of the model `" << model_data->model_path << "' could not be written" << std::endl;
+        return false;
     }
 
     // Setup origin matrix
@@ -230,15 +335,8 @@ bool OBJLoader::read() {
     model_data->origin_mat = glm::translate(glm::scale(glm::mat4(1.0F), glm::vec3(min_dim)), (model_data->min + model_data->max) / -2.0F) ;
 
     // Save statistics
-    model_data->vertices = position_stock.size();
-    model_data->elements = vertex_stock.size();
-    model_data->triangles = index_stock.size() / 3U;
-
-    // Free memory
-    parsed_vertex.clear();
-    position_stock.clear();
-    uv_coord_stock.clear();
-    normal_stock.clear();
+    model_data->triangles = index_count / 3U;
+    model_data->elements = vertex_count;
 
     // Return true if not error has been found
     model_data->model_open = true;
@@ -247,6 +345,8 @@ bool OBJLoader::read() {
 
 // Read material data from file
 bool OBJLoader::readMaterial(const std::string &mtl) {
+    PROFILE_ZONE("OBJLoader::readMaterial");
+
     // Get the relative directory and set the material file path
     model_data->material_path = mtl;
     const std::string relative = model_data->material_path.substr(0U, model_data->material_path.find_last_of(DIR_SEP) + 1U);
@@ -294,7 +394,7 @@ bool OBJLoader::readMaterial(const std::string &mtl) {
         if (token == "newmtl") {
             // Set cube map paths to the previous material
             if (load_cube_map) {
-                material->setCubeMapTexturePath(cube_map_path);
+                material->setCubeMapTexturePath(cube_map_path, false);
 
                 // Clear cube map paths
                 load_cube_map = false;
@@ -367,13 +467,13 @@ bool OBJLoader::readMaterial(const std::string &mtl) {
         }
 
 
-        // Textures
+        // Textures, loaded by the upload in the OpenGL thread
 
         // Ambient texture
         else if (token == "map_ka") {
             stream >> std::ws;
             std::getline(stream, token);
-            material->setTexturePath(Material::AMBIENT, relative + token);
+            material->setTexturePath(Material::AMBIENT, relative + token, false);
             model_data->textures++;
         }
 
@@ -381,7 +481,7 @@ bool OBJLoader::readMaterial(const std::string &mtl) {
         else if (token == "map_kd") {
             stream >> std::ws;
             std::getline(stream, token);
-            material->setTexturePath(Material::DIFFUSE, relative + token);
+            material->setTexturePath(Material::DIFFUSE, relative + token, false);
             model_data->textures++;
         }
 
@@ -389,7 +489,7 @@ bool OBJLoader::readMaterial(const std::string &mtl) {
         else if (token == "map_ks") {
             stream >> std::ws;
             std::getline(stream, token);
-            material->setTexturePath(Material::SPECULAR, relative + token);
+            material->setTexturePath(Material::SPECULAR, relative + token, false);
             model_data->textures++;
         }
 
@@ -397,7 +497,7 @@ bool OBJLoader::readMaterial(const std::string &mtl) {
         else if (token == "map_ns") {
             stream >> std::ws;
             std::getline(stream, token);
-            material->setTexturePath(Material::SHININESS, relative + token);
+            material->setTexturePath(Material::SHININESS, relative + token, false);
             model_data->textures++;
         }
 
@@ -405,7 +505,7 @@ bool OBJLoader::readMaterial(const std::string &mtl) {
         else if ((token == "map_bump") || (token == "bump") || (token == "kn")) {
             stream >> std::ws;
             std::getline(stream, token);
-            material->setTexturePath(Material::NORMAL, relative + token);
+            material->setTexturePath(Material::NORMAL, relative + token, false);
             model_data->textures++;
         }
 
@@ -413,7 +513,7 @@ bool OBJLoader::readMaterial(const std::string &mtl) {
         else if (token == "disp") {
             stream >> std::ws;
             std::getline(stream, token);
-            material->setTexturePath(Material::DISPLACEMENT, relative + token);
+            material->setTexturePath(Material::DISPLACEMENT, relative + token, false);
             model_data->textures++;
         }
 
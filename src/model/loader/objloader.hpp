@@ -8,6 +8,9 @@
 
 /** OBJ model format loader */
 class OBJLoader : public ModelLoader {
+    /** Microbenchmarks of the loader kernels */
+    friend class LoaderBenchmark;
+
     private:
         // Constructors
 
@@ -23,11 +26,11 @@ class OBJLoader : public ModelLoader {
 
         // Methods
 
-        /** Parse, store the vertex and returns its index */
-        GLsizei storeVertex(const std::string &vertex_str);
+        /** Count the attributes and the triangulated face indices with a fast scan, reserve the stocks and set the mapped buffers sizes, false if the file could not be open */
+        bool scan();
 
-        /** Calculate the tangent vector for each vertex of a triangle */
-        void calcTangent(const GLsizei &ind_0, const GLsizei &ind_1, const GLsizei &ind_2);
+        /** Parse, store the vertex and returns its index */
+        GLsizei storeVertex(const char *const vertex_str, const std::size_t &size);
 
         /** Read data from file */
         bool read();
@@ -1,5 +1,8 @@
 #include "material.hpp"
 
+#include "../job/jobsystem.hpp"
+#include "../profiler/profiler.hpp"
+
 #define STBI_ASSERT(x)
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb/stb_image.h"
@@ -63,25 +66,55 @@ void Material::bindTexture(const GLenum &index, const GLuint &texture) {
 }
 
 
-// Load a 2D texture
-GLuint Material::load2DTexture(const std::string &path) {
+// Load a 2D texture and get its fully transparent texels status
+GLuint Material::load2DTexture(const std::string &path, bool &transparent) {
+    PROFILE_ZONE("Material::load2DTexture");
+
     // Check if path is empty
+    transparent = false;
     if (path.empty()) {
         return GL_FALSE;
     }
 
-    // Image properties
-    int width;
-    int height;
-    int channels;
+    // Decode the image and upload it
+    stbi_set_flip_vertically_on_load(true);
+    Material::Image image;
+    if (!Material::decode2DTexture(path, image)) {
+        return GL_FALSE;
+    }
+
+    transparent = image.transparent;
+    return Material::upload2DTexture(image);
+}
+
+// Decode a 2D texture without OpenGL calls, false if it could not be opened
+bool Material::decode2DTexture(const std::string &path, Material::Image &image) {
+    PROFILE_ZONE("Material::decode2DTexture");
 
     // Open image as RGBA
-    stbi_set_flip_vertically_on_load(true);
-    stbi_uc *data = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    int channels;
+    image.data = stbi_load(path.c_str(), &image.width, &image.height, &channels, STBI_rgb_alpha);
 
     // Check data
-    if (data == nullptr) {
+    image.transparent = false;
+    if (image.data == nullptr) {
         std::cerr << "error: could not open the texture `" << path << "'" << std::endl;
+        return false;
+    }
+
+    // Look for fully transparent texels that the geometry pass discards
+    const std::size_t size = static_cast<std::size_t>(image.width) * static_cast<std::size_t>(image.height) * 4U;
+    for (std::size_t i = 3U; (i < size) && !image.transparent; i += 4U) {
+        image.transparent = image.data[i] == 0U;
+    }
+
+    return true;
+}
+
+// Upload a decoded 2D texture and free its pixels
+GLuint Material::upload2DTexture(Material::Image &image) {
+    // Check data
+    if (image.data == nullptr) {
         return GL_FALSE;
     }
 
@@ -97,11 +130,12 @@ GLuint Material::load2DTexture(const std::string &path) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 
     // Load texture and generate mipmap
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.data);
     glGenerateMipmap(GL_TEXTURE_2D);
 
     // Free memory
-    stbi_image_free(data);
+    stbi_image_free(image.data);
+    image.data = nullptr;
 
     // Return texture
     return texture;
@@ -172,7 +206,13 @@ Material::Material(const std::string &name) :
     texture{GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE},
 
     // Textures enabled status
-    texture_enabled{true, true, true, true, true, true, true} {}
+    texture_enabled{true, true, true, true, true, true, true},
+
+    // No transparent textures
+    texture_transparent{false, false, false, false, false, false},
+
+    // No decoded textures
+    decoded() {}
 
 
 // Getters
@@ -297,6 +337,13 @@ std::string Material::getTexturePath(const Material::Attribute &attrib) const {
 }
 
 
+// Get the opaque status, false if the geometry pass may discard fragments by their alpha
+bool Material::isOpaque() const {
+    const bool transparent_texture = (texture[1] != GL_FALSE) && texture_enabled[1] && texture_transparent[1];
+    return (value[3] < 1.0F) && !transparent_texture;
+}
+
+
 // Setters
 
 // Set the material name
@@ -362,8 +409,8 @@ void Material::setTextureEnabled(const Material::Attribute &attrib, const bool &
     }
 }
 
-// Set the texture path of the given attribute
-void Material::setTexturePath(const Material::Attribute &attrib, const std::string &path) {
+// Set the texture path of the given attribute and reload it unless deferred
+void Material::setTexturePath(const Material::Attribute &attrib, const std::string &path, const bool &reload) {
     switch (attrib) {
         // Set texture path by attribute
         case Material::AMBIENT:      texture_path[0] = path; break;
@@ -397,18 +444,22 @@ void Material::setTexturePath(const Material::Attribute &attrib, const std::stri
     }
 
     // Reload texture
-    reloadTexture(attrib);
+    if (reload) {
+        reloadTexture(attrib);
+    }
 }
 
-// Set the cube map texture path
-void Material::setCubeMapTexturePath(const std::string (&path)[6]) {
+// Set the cube map texture path and reload it unless deferred
+void Material::setCubeMapTexturePath(const std::string (&path)[6], const bool &reload) {
     // Set the texture paths
     for (int i = 6, j = 1; j < 6; j++) {
         texture_path[i] = path[j];
     }
 
     // Reload texture
-    reloadTexture(Material::CUBE_MAP);
+    if (reload) {
+        reloadTexture(Material::CUBE_MAP);
+    }
 }
 
 
@@ -420,7 +471,7 @@ void Material::reloadTexture(const Material::Attribute &attrib) {
     for (int i = 0; i < 6; i++) {
         if (attrib & Material::TEXTURE_ATTRIBUTE[i]) {
             glDeleteTextures(1, &texture[i]);
-            texture[i] = Material::load2DTexture(texture_path[i]);
+            texture[i] = Material::load2DTexture(texture_path[i], texture_transparent[i]);
         }
     }
 
@@ -431,6 +482,30 @@ void Material::reloadTexture(const Material::Attribute &attrib) {
     }
 }
 
+// Load the textures with a path, used after deferred texture paths
+void Material::loadTextures() {
+    // 2D textures, uploading the already decoded ones
+    for (int i = 0; i < 6; i++) {
+        if (decoded[i].ready) {
+            glDeleteTextures(1, &texture[i]);
+            texture_transparent[i] = decoded[i].transparent;
+            texture[i] = Material::upload2DTexture(decoded[i]);
+            decoded[i].ready = false;
+        }
+        else if (!texture_path[i].empty()) {
+            reloadTexture(Material::TEXTURE_ATTRIBUTE[i]);
+        }
+    }
+
+    // Cube map texture
+    for (int i = 6; i < 12; i++) {
+        if (!texture_path[i].empty()) {
+            reloadTexture(Material::CUBE_MAP);
+            break;
+        }
+    }
+}
+
 // Bind material
 void Material::bind(GLSLProgram *const program) const {
     // Check the program
@@ -479,8 +554,17 @@ void Material::bind(GLSLProgram *const program) const {
 
 // Material destructor
 Material::~Material() {
-    // Delete all textures
-    glDeleteTextures(6, &texture[0]);
+    // Delete the uploaded textures, there are none without a context
+    for (int i = 0; i < 6; i++) {
+        if (texture[i] != GL_FALSE) {
+            glDeleteTextures(1, &texture[i]);
+        }
+    }
+
+    // Free the decoded textures never uploaded
+    for (int i = 0; i < 6; i++) {
+        stbi_image_free(decoded[i].data);
+    }
 }
 
 
@@ -525,4 +609,24 @@ void Material::deleteDefaultTextures() {
     Material::default_texture[0] = GL_FALSE;
     Material::default_texture[1] = GL_FALSE;
     Material::default_texture[2] = GL_FALSE;
+}
+
+// Decode the 2D textures of the materials in parallel, the upload is left to loadTextures
+void Material::decodeTextures(const std::vector<Material *> &material) {
+    PROFILE_ZONE("Material::decodeTextures");
+
+    // The flip flag is global in stb_image, set it before the workers decode
+    stbi_set_flip_vertically_on_load(true);
+
+    // A job per texture
+    JobSystem::parallelFor(material.size() * 6U, 1U, [&material] (const std::size_t &begin, const std::size_t &end) {
+        for (std::size_t i = begin; i < end; i++) {
+            Material *const target = material[i / 6U];
+            Material::Image &image = target->decoded[i % 6U];
+            if (!target->texture_path[i % 6U].empty() && !image.ready) {
+                Material::decode2DTexture(target->texture_path[i % 6U], image);
+                image.ready = true;
+            }
+        }
+    });
 }
\ No newline at end of file
@@ -9,6 +9,8 @@
 
 #include <string>
 
+#include <vector>
+
 
 /** Material with textures */
 class Material {
@@ -73,6 +75,27 @@ class Material {
         };
 
     private:
+        // Structs
+
+        /** Decoded image waiting for the upload */
+        struct Image {
+            /** RGBA pixels, null if the decoding failed */
+            unsigned char *data;
+
+            /** Width */
+            int width;
+
+            /** Height */
+            int height;
+
+            /** Fully transparent texels status */
+            bool transparent;
+
+            /** Decoded status, even if it failed */
+            bool ready;
+        };
+
+
         // Attributes
 
         /** Material name */
@@ -93,9 +116,15 @@ class Material {
         /** Texture enabled status */
         bool texture_enabled[7];
 
+        /** 2D textures with fully transparent texels status */
+        bool texture_transparent[6];
+
         /** Texture path */
         std::string texture_path[12];
 
+        /** Decoded 2D textures waiting for the upload */
+        Material::Image decoded[6];
+
 
         // Constructors
 
@@ -129,8 +158,14 @@ class Material {
         /** Bind texture */
         static void bindTexture(const GLenum &index, const GLuint &texture);
 
-        /** Load a 2D texture */
-        static GLuint load2DTexture(const std::string &path);
+        /** Load a 2D texture and get its fully transparent texels status */
+        static GLuint load2DTexture(const std::string &path, bool &transparent);
+
+        /** Decode a 2D texture without OpenGL calls, false if it could not be opened */
+        static bool decode2DTexture(const std::string &path, Material::Image &image);
+
+        /** Upload a decoded 2D texture and free its pixels */
+        static GLuint upload2DTexture(Material::Image &image);
 
         /** Load a cube map texture */
         static GLuint loadCubeMapTexture(const std::string (&path)[6]);
@@ -163,6 +198,10 @@ class Material {
         std::string getTexturePath(const Material::Attribute &attrib) const;
 
 
+        /** Get the opaque status, false if the geometry pass may discard fragments by their alpha */
+        bool isOpaque() const;
+
+
         // Setters
 
         /** Set the material name */
@@ -177,11 +216,11 @@ class Material {
         /** Get the texture enabled status */
         void setTextureEnabled(const Material::Attribute &attrib, const bool &status);
 
-        /** Set the texture path of the given attribute */
-        void setTexturePath(const Material::Attribute &attrib, const std::string &path);
+        /** Set the texture path of the given attribute and reload it unless deferred */
+        void setTexturePath(const Material::Attribute &attrib, const std::string &path, const bool &reload = true);
 
-        /** Set the cube map texture path */
-        void setCubeMapTexturePath(const std::string (&path)[6]);
+        /** Set the cube map texture path and reload it unless deferred */
+        void setCubeMapTexturePath(const std::string (&path)[6], const bool &reload = true);
 
 
         // Methods
@@ -189,6 +228,9 @@ class Material {
         /** Reload texture */
         void reloadTexture(const Material::Attribute &attrib);
 
+        /** Load the textures with a path, used after deferred texture paths */
+        void loadTextures();
+
         /** Bind material */
         void bind(GLSLProgram *const program) const;
 
@@ -206,6 +248,10 @@ class Material {
 
         /** Delete the default textures */
         static void deleteDefaultTextures();
+
+
+        /** Decode the 2D textures of the materials in parallel, the upload is left to loadTextures */
+        static void decodeTextures(const std::vector<Material *> &material);
 };
 
 #endif // __MATERIAL_HPP_
\ No newline at end of file
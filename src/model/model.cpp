@@ -1,21 +1,31 @@
 #include "model.hpp"
 
+#include "../job/jobsystem.hpp"
 #include "../dirsep.h"
 
 #include "loader/modelloader.hpp"
 
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <cmath>
 #include <iostream>
 
 
+// Private static const attributes
+
+// Smallest absolute scale, keeps the normal matrix finite
+const float Model::MIN_SCALE = 0.001F;
+
+
 // Private methods
 
 // Load the model from the model path
 void Model::load() {
-    // Load the model
-    ModelData *model_data = ModelLoader::load(model_path, ModelLoader::OBJ);
+    load(ModelLoader::load(model_path, ModelLoader::OBJ));
+}
 
+// Take the loaded model data and delete it
+void Model::load(ModelData *const model_data) {
     // Seyt the open statuses
     model_open = model_data->model_open;
     material_open = model_data->material_open;
@@ -25,18 +35,25 @@ void Model::load() {
 
     // Set the geometry
     origin_mat = model_data->origin_mat;
-    model_origin_mat = model_mat * origin_mat;
+    matrices_outdated = true;
     min = model_data->min;
     max = model_data->max;
 
     // Set the buffers
     vao = model_data->vao;
     vbo = model_data->vbo;
+    attribute_vbo = model_data->attribute_vbo;
     ebo = model_data->ebo;
+    basic_vao = model_data->basic_vao;
+    depth_vao = model_data->depth_vao;
+    tangent_vbo = model_data->tangent_vbo;
 
-    // Set the stocks
-    material_stock = model_data->material_stock;
-    object_stock = model_data->object_stock;
+    // Take the stocks
+    material_stock.swap(model_data->material_stock);
+    object_stock.swap(model_data->object_stock);
+    occluder_stock.swap(model_data->occluder_stock);
+    occluder_object.swap(model_data->occluder_object);
+    occluder_opaque.clear();
 
     // Statistics
     vertices  = model_data->vertices;
@@ -49,8 +66,6 @@ void Model::load() {
 
 
     // Clean up the loader data
-    model_data->object_stock.clear();
-    model_data->material_stock.clear();
     delete model_data;
 }
 
@@ -65,18 +80,27 @@ void Model::clear() {
 
     // Geometry
     origin_mat = glm::mat4(1.0F);
+    matrices_outdated = true;
     min = glm::vec3(INFINITY);
     max = glm::vec3(-INFINITY);
 
     // Delete buffers
     glDeleteBuffers(1, &ebo);
+    glDeleteBuffers(1, &tangent_vbo);
+    glDeleteBuffers(1, &attribute_vbo);
     glDeleteBuffers(1, &vbo);
     glDeleteBuffers(1, &vao);
+    glDeleteVertexArrays(1, &basic_vao);
+    glDeleteVertexArrays(1, &depth_vao);
 
     // Reset buffers
     vao = GL_FALSE;
     vbo = GL_FALSE;
+    attribute_vbo = GL_FALSE;
     ebo = GL_FALSE;
+    basic_vao = GL_FALSE;
+    depth_vao = GL_FALSE;
+    tangent_vbo = GL_FALSE;
 
     // Statistics
     vertices  = 0U;
@@ -85,8 +109,15 @@ void Model::clear() {
     textures  = 0U;
 
     // Clear stocks
+    for (const Material *const material : material_stock) {
+        delete material;
+    }
     object_stock.clear();
     material_stock.clear();
+    occluder_stock.clear();
+    occluder_object.clear();
+    opaque_occluder.clear();
+    occluder_opaque.clear();
 
     // Clear the default material
     if (default_material != nullptr) {
@@ -95,19 +126,48 @@ void Model::clear() {
     }
 }
 
-// Update the model and normal matrices
-void Model::updateMatrices() {
-    // Get the transformation matrices
-    const glm::mat4 identity = glm::mat4(1.0F);
-    const glm::mat4 translation_mat = glm::translate(identity, position);
-    const glm::mat4 rotation_mat    = glm::mat4_cast(rotation);
-    const glm::mat4 scale_mat       = glm::scale(identity, dimension);
+// Update the model and normal matrices if they are outdated
+void Model::updateMatrices() const {
+    if (matrices_outdated) {
+        Model::composeMatrices(position, rotation, dimension, origin_mat, model_mat, model_origin_mat, normal_mat);
+        matrices_outdated = false;
+    }
+}
+
+
+// Private static methods
+
+// Keep the scale components finite and away from zero
+glm::vec3 Model::clampScale(const glm::vec3 &scale) {
+    glm::vec3 clamped = scale;
+    for (int i = 0; i < 3; i++) {
+        if (!std::isfinite(clamped[i])) {
+            clamped[i] = Model::MIN_SCALE;
+        }
+        else if (std::abs(clamped[i]) < Model::MIN_SCALE) {
+            clamped[i] = clamped[i] < 0.0F ? -Model::MIN_SCALE : Model::MIN_SCALE;
+        }
+    }
+
+    return clamped;
+}
+
+// Compose the model, model origin and normal matrices from the transform
+void Model::composeMatrices(const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale, const glm::mat4 &origin, glm::mat4 &model, glm::mat4 &model_origin, glm::mat3 &normal) {
+    // Rotation matrix straight from the quaternion
+    const glm::mat3 rotation_mat = glm::mat3_cast(rotation);
+
+    // Translation, rotation and scale without the full matrix products
+    model[0] = glm::vec4(rotation_mat[0] * scale.x, 0.0F);
+    model[1] = glm::vec4(rotation_mat[1] * scale.y, 0.0F);
+    model[2] = glm::vec4(rotation_mat[2] * scale.z, 0.0F);
+    model[3] = glm::vec4(position, 1.0F);
+    model_origin = model * origin;
 
-    // Update the model, model_origin and normal matrix
-    const glm::mat4 translation_rotation_mat = translation_mat * rotation_mat;
-    model_mat = translation_rotation_mat * scale_mat;
-    model_origin_mat = model_mat * origin_mat;
-    normal_mat = glm::inverse(glm::transpose(translation_rotation_mat));
+    // The inverse transpose of the rotation and scale is the rotation by the inverse scale
+    normal[0] = rotation_mat[0] / scale.x;
+    normal[1] = rotation_mat[1] / scale.y;
+    normal[2] = rotation_mat[2] / scale.z;
 }
 
 // Constructor
@@ -128,6 +188,7 @@ Model::Model() :
     model_mat(1.0F),
     model_origin_mat(1.0F),
     normal_mat(1.0F),
+    matrices_outdated(false),
 
     // Default material
     default_material(nullptr) {}
@@ -148,6 +209,7 @@ Model::Model(const std::string &path) :
     model_mat(1.0F),
     model_origin_mat(1.0F),
     normal_mat(1.0F),
+    matrices_outdated(true),
 
     // Default material
     default_material(nullptr)  {
@@ -155,6 +217,30 @@ Model::Model(const std::string &path) :
     load();
 }
 
+// Model constructor from a loader that has already read the model path
+Model::Model(const std::string &path, ModelLoader *const loader) :
+    ModelData(path),
+
+    // Enabled
+    enabled(true),
+
+    // Geometry
+    position(0.0F),
+    rotation(glm::quat()),
+    dimension(1.0F),
+
+    // Matrices
+    model_mat(1.0F),
+    model_origin_mat(1.0F),
+    normal_mat(1.0F),
+    matrices_outdated(true),
+
+    // Default material
+    default_material(nullptr)  {
+    // Upload the read model
+    load(ModelLoader::upload(loader));
+}
+
 
 // Getters
 
@@ -174,6 +260,11 @@ bool Model::isMaterialOpen() const {
     return material_open;
 }
 
+// Get the generated tangents status
+bool Model::hasTangents() const {
+    return tangent_vbo != GL_FALSE;
+}
+
 
 // Get the model name
 std::string Model::getName() const {
@@ -215,11 +306,13 @@ glm::mat4 Model::getOriginMatrix() const {
 
 // Get the model matrix
 glm::mat4 Model::getModelMatrix() const {
+    updateMatrices();
     return model_mat;
 }
 
 // Get the normal matrix
 glm::mat4 Model::getNormalMatrix() const {
+    updateMatrices();
     return normal_mat;
 }
 
@@ -254,6 +347,45 @@ glm::vec3 Model::getMin() const {
     return min;
 }
 
+// Get the maximum position values of an object
+glm::vec3 Model::getObjectMax(const std::size_t &index) const {
+    return object_stock[index].max;
+}
+
+// Get the minimum position values of an object
+glm::vec3 Model::getObjectMin(const std::size_t &index) const {
+    return object_stock[index].min;
+}
+
+// Get the occluder triangles positions of the opaque objects, the discarded fragments must not occlude
+const std::vector<glm::vec3> &Model::getOccluder() const {
+    // Check the objects opaque status since the last build
+    bool outdated = occluder_opaque.size() != object_stock.size();
+    occluder_opaque.resize(object_stock.size());
+    for (std::size_t i = 0U; i < object_stock.size(); i++) {
+        const unsigned char opaque = isObjectOpaque(i);
+        outdated = outdated || (occluder_opaque[i] != opaque);
+        occluder_opaque[i] = opaque;
+    }
+
+    // Keep the triangles of the opaque objects
+    if (outdated) {
+        opaque_occluder.clear();
+        for (std::size_t i = 0U; i < occluder_object.size(); i++) {
+            if ((occluder_object[i] < occluder_opaque.size()) && (occluder_opaque[occluder_object[i]] != 0U)) {
+                opaque_occluder.insert(opaque_occluder.end(), occluder_stock.begin() + static_cast<std::ptrdiff_t>(3U * i), occluder_stock.begin() + static_cast<std::ptrdiff_t>(3U * i + 3U));
+            }
+        }
+    }
+
+    return opaque_occluder;
+}
+
+// Get the opaque status of an object material
+bool Model::isObjectOpaque(const std::size_t &index) const {
+    return material_stock[object_stock[index].material]->isOpaque();
+}
+
 
 // Get the number of vertices
 std::size_t Model::getNumberOfVertices() const {
@@ -280,6 +412,16 @@ std::size_t Model::getNumberOfTextures() const {
     return textures;
 }
 
+// Get the number of objects
+std::size_t Model::getNumberOfObjects() const {
+    return object_stock.size();
+}
+
+// Get the largest resident set size growth of the process sampled during the load in kilobytes
+long Model::getLoadMemory() const {
+    return load_memory;
+}
+
 
 // Setters
 
@@ -299,25 +441,25 @@ void Model::setPath(const std::string &new_path) {
 // Set the new position
 void Model::setPosition(const glm::vec3 &new_position) {
     position = new_position;
-    updateMatrices();
+    matrices_outdated = true;
 }
 
 // Set the new rotation angles in degrees
 void Model::setRotation(const glm::vec3 &new_rotation) {
     rotation = glm::quat(glm::radians(new_rotation));
-    updateMatrices();
+    matrices_outdated = true;
 }
 
 // Set the new rotation quaternion
 void Model::setRotation(const glm::quat &new_rotation) {
     rotation = new_rotation;
-    updateMatrices();
+    matrices_outdated = true;
 }
 
 // Set the new scale
 void Model::setScale(const glm::vec3 &new_scale) {
-    dimension = new_scale;
-    updateMatrices();
+    dimension = Model::clampScale(new_scale);
+    matrices_outdated = true;
 }
 
 
@@ -364,24 +506,10 @@ bool Model::reloadMaterial() {
         return false;
     }
 
-    // Update the object and material stock
-    for (ModelData::Object *const object : object_stock) {
-        // Get the old material
-        const Material *const &old_material = object->material;
-
-        // Replace material
-        for (std::size_t i = 0U; i < materials; i++) {
-            Material *&material = material_stock[i];
-            if (material == old_material) {
-                // Delete the old material
-                delete old_material;
-
-                // Set the new material
-                material = material_data[i];
-                object->material = material;
-                break;
-            }
-        }
+    // Replace the materials, the objects refer to them by index
+    for (std::size_t i = 0U; i < materials; i++) {
+        delete material_stock[i];
+        material_stock[i] = material_data[i];
     }
 
     // Return success
@@ -395,72 +523,157 @@ void Model::resetGeometry() {
     rotation = glm::quat();
     dimension = glm::vec3(1.0F);
 
-    // Update matrices
-    updateMatrices();
+    // Outdate the matrices
+    matrices_outdated = true;
+}
+
+// Generate the tangents on their first use, false if they are not available
+bool Model::loadTangents() {
+    // Already generated
+    if (tangent_vbo != GL_FALSE) {
+        return true;
+    }
+
+    // Read back the buffers of the open model
+    return model_open && ModelLoader::loadTangents(this);
 }
 
 
-// Draw the model
-void Model::draw(GLSLProgram *const program) const {
+// Draw the model and get the number of draw calls, skipping the objects without the visible flag if given
+std::size_t Model::draw(GLSLProgram *const program, const unsigned char *const visible) const {
     // Check model and program status
     if (!enabled || !model_open || (program == nullptr) || (!program->isValid())) {
-        return;
+        return 0U;
     }
 
     // Use the program
     program->use();
 
     // Set model uniforms
+    updateMatrices();
     program->setUniform("u_model_mat", model_origin_mat);
     program->setUniform("u_normal_mat", normal_mat);
 
-    // Bind the vertex array object
-    glBindVertexArray(vao);
+    // Bind the vertex array object fetching only the attributes the program reads
+    glBindVertexArray(program->isAttributeActive("l_tangent") ? vao : basic_vao);
+
+    // Draw the visible objects
+    std::size_t calls = 0U;
+    for (std::size_t i = 0U; i < object_stock.size(); i++) {
+        if ((visible != nullptr) && (visible[i] == 0U)) {
+            continue;
+        }
 
-    // Draw the objects
-    for (const ModelData::Object *const object : object_stock) {
         // Bind material
-        object->material->bind(program);
+        const ModelData::Object &object = object_stock[i];
+        material_stock[object.material]->bind(program);
 
         // Draw triangles
-        glDrawElements(GL_TRIANGLES, object->count, GL_UNSIGNED_INT, reinterpret_cast<void *>(static_cast<intptr_t>(object->offset)));
+        glDrawElements(GL_TRIANGLES, object.count, GL_UNSIGNED_INT, reinterpret_cast<void *>(static_cast<intptr_t>(object.offset)));
+        calls++;
+    }
+
+    // Unbind the vertex array object
+    glBindVertexArray(GL_FALSE);
+
+    return calls;
+}
+
+// Draw only the depth of the objects with the visible flag, merging the contiguous ones, and get the number of draw calls
+std::size_t Model::drawDepth(GLSLProgram *const program, const unsigned char *const visible) const {
+    // Check model and program status
+    if (!enabled || !model_open || (program == nullptr) || (!program->isValid())) {
+        return 0U;
+    }
+
+    // Use the program
+    program->use();
+
+    // Set model uniforms
+    updateMatrices();
+    program->setUniform("u_model_mat", model_origin_mat);
+
+    // Bind the position only vertex array object
+    glBindVertexArray(depth_vao);
+
+    // Draw the runs of visible objects stored contiguously in the element buffer
+    std::size_t calls = 0U;
+    for (std::size_t i = 0U; i < object_stock.size(); i++) {
+        if (visible[i] == 0U) {
+            continue;
+        }
+
+        const GLsizei offset = object_stock[i].offset;
+        GLsizei count = object_stock[i].count;
+        while ((i + 1U < object_stock.size()) && (visible[i + 1U] != 0U) && (object_stock[i + 1U].offset == offset + count * static_cast<GLsizei>(sizeof(GLuint)))) {
+            count += object_stock[++i].count;
+        }
+
+        glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, reinterpret_cast<void *>(static_cast<intptr_t>(offset)));
+        calls++;
+    }
+
+    // Unbind the vertex array object
+    glBindVertexArray(GL_FALSE);
+
+    return calls;
+}
+
+// Draw a single object and get the number of draw calls
+std::size_t Model::drawObject(GLSLProgram *const program, const std::size_t &index) const {
+    // Check model, object and program status
+    if (!enabled || !model_open || (index >= object_stock.size()) || (program == nullptr) || (!program->isValid())) {
+        return 0U;
     }
 
+    // Use the program
+    program->use();
+
+    // Set model uniforms
+    updateMatrices();
+    program->setUniform("u_model_mat", model_origin_mat);
+    program->setUniform("u_normal_mat", normal_mat);
+
+    // Bind the vertex array object and the material
+    const ModelData::Object &object = object_stock[index];
+    glBindVertexArray(program->isAttributeActive("l_tangent") ? vao : basic_vao);
+    material_stock[object.material]->bind(program);
+
+    // Draw triangles
+    glDrawElements(GL_TRIANGLES, object.count, GL_UNSIGNED_INT, reinterpret_cast<void *>(static_cast<intptr_t>(object.offset)));
+
     // Unbind the vertex array object
     glBindVertexArray(GL_FALSE);
+
+    return 1U;
 }
 
 
 // Translate the model
 void Model::translate(const glm::vec3 &delta) {
     position += delta;
-    updateMatrices();
+    matrices_outdated = true;
 }
 
 // Rotate certain degrees
 void Model::rotate(const glm::vec3 &delta) {
     rotation = glm::normalize(glm::quat(glm::radians(delta)) * rotation);
-    updateMatrices();
+    matrices_outdated = true;
 }
 
 // Rotate applying the quaternion
 void Model::rotate(const glm::quat &factor) {
     rotation = glm::normalize(factor * rotation);
-    updateMatrices();
+    matrices_outdated = true;
 }
 
 // Scale the given factor
 void Model::scale(const glm::vec3 &factor) {
-    // Scale
-    dimension *= factor;
+    // Scale keeping it finite and away from zero
+    dimension = Model::clampScale(dimension * factor);
 
-    // Fix not a number
-    if (!std::isfinite(dimension.x)) dimension.x = 0.001F;
-    if (!std::isfinite(dimension.y)) dimension.y = 0.001F;
-    if (!std::isfinite(dimension.z)) dimension.z = 0.001F;
-
-    // Update matrices
-    updateMatrices();
+    // Outdate the matrices
+    matrices_outdated = true;
 }
 
 
@@ -469,4 +682,29 @@ void Model::scale(const glm::vec3 &factor) {
 // Model destructor
 Model::~Model() {
     clear();
+}
+
+
+// Static methods
+
+// Set the transforms of many models from arrays of positions, rotations and scales
+void Model::setTransforms(const std::vector<Model *> &model, const std::vector<glm::vec3> &position, const std::vector<glm::quat> &rotation, const std::vector<glm::vec3> &scale) {
+    // Check the arrays sizes
+    const std::size_t count = model.size();
+    if ((position.size() != count) || (rotation.size() != count) || (scale.size() != count)) {
+        std::cerr << "error: the transforms arrays sizes does not match the number of models" << std::endl;
+        return;
+    }
+
+    // Compose all the matrices in parallel passes over the arrays
+    JobSystem::parallelFor(count, 256U, [&] (const std::size_t &begin, const std::size_t &end) {
+        for (std::size_t i = begin; i < end; i++) {
+            Model *const instance = model[i];
+            instance->position  = position[i];
+            instance->rotation  = rotation[i];
+            instance->dimension = Model::clampScale(scale[i]);
+            Model::composeMatrices(position[i], rotation[i], instance->dimension, instance->origin_mat, instance->model_mat, instance->model_origin_mat, instance->normal_mat);
+            instance->matrices_outdated = false;
+        }
+    });
 }
\ No newline at end of file
@@ -39,13 +39,23 @@ class Model : private ModelData {
 
 
         /** Model matrix */
-        glm::mat4 model_mat;
+        mutable glm::mat4 model_mat;
 
         /** Origin matrix multiply by the model matrix */
-        glm::mat4 model_origin_mat;
+        mutable glm::mat4 model_origin_mat;
 
         /** Normal matrix */
-        glm::mat3 normal_mat;
+        mutable glm::mat3 normal_mat;
+
+        /** Outdated matrices status, they are rebuilt on the next read */
+        mutable bool matrices_outdated;
+
+
+        /** Occluder triangles positions of the opaque objects */
+        mutable std::vector<glm::vec3> opaque_occluder;
+
+        /** Opaque status of each object when the opaque occluder was built */
+        mutable std::vector<unsigned char> occluder_opaque;
 
 
         /** Default material */
@@ -66,11 +76,29 @@ class Model : private ModelData {
         /** Load the model from the model path */
         void load();
 
+        /** Take the loaded model data and delete it */
+        void load(ModelData *const model_data);
+
         /** Makes the model empty */
         void clear();
 
-        /** Update model and normal matrices */
-        void updateMatrices();
+        /** Update the model and normal matrices if they are outdated */
+        void updateMatrices() const;
+
+
+        // Static const attributes
+
+        /** Smallest absolute scale, keeps the normal matrix finite */
+        static const float MIN_SCALE;
+
+
+        // Static methods
+
+        /** Keep the scale components finite and away from zero */
+        static glm::vec3 clampScale(const glm::vec3 &scale);
+
+        /** Compose the model, model origin and normal matrices from the transform */
+        static void composeMatrices(const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale, const glm::mat4 &origin, glm::mat4 &model, glm::mat4 &model_origin, glm::mat3 &normal);
 
 
     public:
@@ -82,6 +110,9 @@ class Model : private ModelData {
         /** Model constructor */
         Model(const std::string &path);
 
+        /** Model constructor from a loader that has already read the model path */
+        Model(const std::string &path, ModelLoader *const loader);
+
 
         // Getters
 
@@ -95,6 +126,9 @@ class Model : private ModelData {
         /** Get the open material status */
         bool isMaterialOpen() const;
 
+        /** Get the generated tangents status */
+        bool hasTangents() const;
+
 
         /** Get the model name */
         std::string getName() const;
@@ -141,6 +175,18 @@ class Model : private ModelData {
         /** Get the minimum position values */
         glm::vec3 getMin() const;
 
+        /** Get the maximum position values of an object */
+        glm::vec3 getObjectMax(const std::size_t &index) const;
+
+        /** Get the minimum position values of an object */
+        glm::vec3 getObjectMin(const std::size_t &index) const;
+
+        /** Get the occluder triangles positions of the opaque objects, the discarded fragments must not occlude */
+        const std::vector<glm::vec3> &getOccluder() const;
+
+        /** Get the opaque status of an object material */
+        bool isObjectOpaque(const std::size_t &index) const;
+
 
         /** Get the number of vertices */
         std::size_t getNumberOfVertices() const;
@@ -157,6 +203,12 @@ class Model : private ModelData {
         /** Get the number of textures */
         std::size_t getNumberOfTextures() const;
 
+        /** Get the number of objects */
+        std::size_t getNumberOfObjects() const;
+
+        /** Get the largest resident set size growth of the process sampled during the load in kilobytes */
+        long getLoadMemory() const;
+
 
         // Setters
 
@@ -192,9 +244,18 @@ class Model : private ModelData {
         /** Reset geometry */
         void resetGeometry();
 
+        /** Generate the tangents on their first use, false if they are not available */
+        bool loadTangents();
 
-        /** Draw the model */
-        void draw(GLSLProgram *const program) const;
+
+        /** Draw the model and get the number of draw calls, skipping the objects without the visible flag if given */
+        std::size_t draw(GLSLProgram *const program, const unsigned char *const visible = nullptr) const;
+
+        /** Draw only the depth of the objects with the visible flag, merging the contiguous ones, and get the number of draw calls */
+        std::size_t drawDepth(GLSLProgram *const program, const unsigned char *const visible) const;
+
+        /** Draw a single object and get the number of draw calls */
+        std::size_t drawObject(GLSLProgram *const program, const std::size_t &index) const;
 
 
         /** Translate the model */
@@ -214,6 +275,12 @@ class Model : private ModelData {
 
         /** Model destructor */
         virtual ~Model();
+
+
+        // Static methods
+
+        /** Set the transforms of many models from arrays of positions, rotations and scales */
+        static void setTransforms(const std::vector<Model *> &model, const std::vector<glm::vec3> &position, const std::vector<glm::quat> &rotation, const std::vector<glm::vec3> &scale);
 };
 
 #endif // __MODEL_HPP_
\ No newline at end of file
@@ -0,0 +1,230 @@
+#include "profiler.hpp"
+
+#include <chrono>
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+
+// Private static const attributes
+
+// Events per thread ring buffer
+const std::size_t Profiler::RING_SIZE = 1U << 16U;
+
+// Stored frame marks
+const std::size_t Profiler::FRAME_MARKS;
+
+
+// Private static attributes
+
+// Enabled status
+std::atomic<bool> Profiler::enabled(true);
+
+// Time stamps origin
+const std::int64_t Profiler::origin = Profiler::now();
+
+
+// Buffers stock mutex
+std::mutex Profiler::buffer_mutex;
+
+// Buffers stock
+std::forward_list<Profiler::Buffer> Profiler::buffer_stock;
+
+// Number of buffers
+std::uint32_t Profiler::buffers = 0U;
+
+// Buffer of the current thread
+thread_local Profiler::Buffer *Profiler::buffer = nullptr;
+
+
+// Frame marks time stamps
+std::int64_t Profiler::frame_mark[Profiler::FRAME_MARKS];
+
+// Total of frame marks
+std::size_t Profiler::frames = 0U;
+
+
+// Zone
+
+// Zone constructor, records the start time
+Profiler::Zone::Zone(const char *const name) :
+    name(name),
+    start(Profiler::now()) {}
+
+// Zone destructor, records the zone
+Profiler::Zone::~Zone() {
+    Profiler::record(name, start, Profiler::now());
+}
+
+
+// Batch
+
+// Batch constructor
+Profiler::Batch::Batch(const char *const name, const std::uint32_t &size) :
+    name(name),
+    size(size),
+    count(0U),
+    first_start(0),
+    last_end(0) {}
+
+// Begin an item
+void Profiler::Batch::begin() {
+    if (count == 0U) {
+        first_start = Profiler::now();
+    }
+}
+
+// End an item and record the event if the batch is full
+void Profiler::Batch::end() {
+    last_end = Profiler::now();
+    if (++count == size) {
+        flush();
+    }
+}
+
+// Record the pending items
+void Profiler::Batch::flush() {
+    if (count > 0U) {
+        Profiler::record(name, first_start, last_end, count);
+        count = 0U;
+    }
+}
+
+// Batch destructor, records the pending items
+Profiler::Batch::~Batch() {
+    flush();
+}
+
+
+// Buffer
+
+// Buffer constructor
+Profiler::Buffer::Buffer(const std::uint32_t &thread) :
+    thread(thread),
+    ring(Profiler::RING_SIZE),
+    head(0U) {}
+
+
+// Private static methods
+
+// Get the buffer of the current thread
+Profiler::Buffer *Profiler::getBuffer() {
+    // Register a new buffer for the first event of the thread
+    if (Profiler::buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(Profiler::buffer_mutex);
+        Profiler::buffer_stock.emplace_front(Profiler::buffers++);
+        Profiler::buffer = &Profiler::buffer_stock.front();
+    }
+
+    return Profiler::buffer;
+}
+
+
+// Static getters
+
+// Get the enabled status
+bool Profiler::isEnabled() {
+    return Profiler::enabled.load(std::memory_order_relaxed);
+}
+
+// Get the current time stamp in nanoseconds
+std::int64_t Profiler::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+// Static setters
+
+// Set the enabled status
+void Profiler::setEnabled(const bool &status) {
+    Profiler::enabled.store(status, std::memory_order_relaxed);
+}
+
+
+// Static methods
+
+// Record an event
+void Profiler::record(const char *const name, const std::int64_t &start, const std::int64_t &end, const std::uint32_t &count) {
+    // Skip while disabled
+    if (!Profiler::isEnabled()) {
+        return;
+    }
+
+    // Write the event into the ring and publish it
+    Profiler::Buffer *const thread_buffer = Profiler::getBuffer();
+    std::lock_guard<std::mutex> lock(thread_buffer->mutex);
+    const std::size_t head = thread_buffer->head.load(std::memory_order_relaxed);
+    Profiler::Event &event = thread_buffer->ring[head % Profiler::RING_SIZE];
+    event.name  = name;
+    event.start = start;
+    event.end   = end;
+    event.count = count;
+    thread_buffer->head.store(head + 1U, std::memory_order_release);
+}
+
+// Mark the start of a frame, only from the main thread
+void Profiler::markFrame() {
+    Profiler::frame_mark[Profiler::frames % Profiler::FRAME_MARKS] = Profiler::now();
+    Profiler::frames++;
+}
+
+// Dump the events of the last frames, or all the stored events for zero frames, as a Chrome trace JSON
+bool Profiler::dump(const std::string &path, const std::size_t &last_frames) {
+    // Open the trace file
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "error: could not open the trace file `" << path << "'" << std::endl;
+        return false;
+    }
+
+    // Oldest time stamp to dump
+    std::int64_t threshold = Profiler::origin;
+    if ((last_frames > 0U) && (Profiler::frames > 0U)) {
+        const std::size_t marks = std::min(std::min(last_frames, Profiler::frames), Profiler::FRAME_MARKS);
+        threshold = Profiler::frame_mark[(Profiler::frames - marks) % Profiler::FRAME_MARKS];
+    }
+
+    // Write the events of each thread in microseconds
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::fixed << std::setprecision(3);
+    bool first = true;
+    std::size_t events = 0U;
+    std::vector<Profiler::Event> snapshot;
+    std::lock_guard<std::mutex> lock(Profiler::buffer_mutex);
+    for (Profiler::Buffer &thread_buffer : Profiler::buffer_stock) {
+        // Thread name metadata
+        file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread_buffer.thread << ",\"args\":{\"name\":\"Thread " << thread_buffer.thread << "\"}}";
+        first = false;
+
+        // Copy the stored events of the ring in order while its thread cannot record
+        {
+            std::lock_guard<std::mutex> ring_lock(thread_buffer.mutex);
+            const std::size_t head = thread_buffer.head.load(std::memory_order_acquire);
+            snapshot.clear();
+            for (std::size_t i = head > Profiler::RING_SIZE ? head - Profiler::RING_SIZE : 0U; i < head; i++) {
+                snapshot.push_back(thread_buffer.ring[i % Profiler::RING_SIZE]);
+            }
+        }
+
+        // Stored events of the ring
+        for (const Profiler::Event &event : snapshot) {
+            if (event.end < threshold) {
+                continue;
+            }
+
+            file << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread_buffer.thread
+                 << ",\"ts\":" << (event.start - Profiler::origin) * 1.0E-3
+                 << ",\"dur\":" << (event.end - event.start) * 1.0E-3;
+            if (event.count > 0U) {
+                file << ",\"args\":{\"count\":" << event.count << "}";
+            }
+            file << "}";
+            events++;
+        }
+    }
+    file << "\n]}\n";
+
+    // Report the dumped events
+    std::cout << "trace: " << events << " events written to `" << path << "'" << std::endl;
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,230 @@
+#ifndef __PROFILER_HPP_
+#define __PROFILER_HPP_
+
+#include <atomic>
+#include <mutex>
+
+#include <cstdint>
+#include <string>
+
+#include <forward_list>
+#include <vector>
+
+
+// Unique zone variable names
+#define PROFILER_CONCAT_(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_(a, b)
+
+/** Profile the enclosing scope with the given name literal */
+#define PROFILE_ZONE(name) Profiler::Zone PROFILER_CONCAT(profiler_zone_, __LINE__)(name)
+
+
+/** Scoped CPU zones profiler with Chrome trace export */
+class Profiler {
+    public:
+        /** Scoped zone */
+        class Zone {
+            private:
+                // Attributes
+
+                /** Zone name */
+                const char *const name;
+
+                /** Start time stamp */
+                const std::int64_t start;
+
+
+                // Constructors
+
+                /** Disable the default copy constructor */
+                Zone(const Zone &) = delete;
+
+                /** Disable the assignation operator */
+                Zone &operator=(const Zone &) = delete;
+
+
+            public:
+                // Constructor
+
+                /** Zone constructor, records the start time */
+                Zone(const char *const name);
+
+
+                // Destructor
+
+                /** Zone destructor, records the zone */
+                ~Zone();
+        };
+
+        /** Batch of short repeated zones recorded as a single event every given number of items */
+        class Batch {
+            private:
+                // Attributes
+
+                /** Batch name */
+                const char *const name;
+
+                /** Items per event */
+                const std::uint32_t size;
+
+                /** Items in the current event */
+                std::uint32_t count;
+
+                /** Start time stamp of the first item */
+                std::int64_t first_start;
+
+                /** End time stamp of the last item */
+                std::int64_t last_end;
+
+
+                // Constructors
+
+                /** Disable the default copy constructor */
+                Batch(const Batch &) = delete;
+
+                /** Disable the assignation operator */
+                Batch &operator=(const Batch &) = delete;
+
+
+            public:
+                // Constructor
+
+                /** Batch constructor */
+                Batch(const char *const name, const std::uint32_t &size = 1024U);
+
+
+                // Methods
+
+                /** Begin an item */
+                void begin();
+
+                /** End an item and record the event if the batch is full */
+                void end();
+
+                /** Record the pending items */
+                void flush();
+
+
+                // Destructor
+
+                /** Batch destructor, records the pending items */
+                ~Batch();
+        };
+
+
+    private:
+        // Structures
+
+        /** Recorded event */
+        struct Event {
+            /** Name */
+            const char *name;
+
+            /** Start time stamp in nanoseconds */
+            std::int64_t start;
+
+            /** End time stamp in nanoseconds */
+            std::int64_t end;
+
+            /** Number of batched items */
+            std::uint32_t count;
+        };
+
+        /** Events ring buffer of a thread */
+        struct Buffer {
+            /** Thread ID */
+            std::uint32_t thread;
+
+            /** Events ring */
+            std::vector<Profiler::Event> ring;
+
+            /** Total of recorded events */
+            std::atomic<std::size_t> head;
+
+            /** Events ring mutex, only contended while dumping */
+            std::mutex mutex;
+
+            /** Buffer constructor */
+            Buffer(const std::uint32_t &thread);
+        };
+
+
+        // Static const attributes
+
+        /** Events per thread ring buffer */
+        static const std::size_t RING_SIZE;
+
+        /** Stored frame marks */
+        static const std::size_t FRAME_MARKS = 1024U;
+
+
+        // Static attributes
+
+        /** Enabled status */
+        static std::atomic<bool> enabled;
+
+        /** Time stamps origin */
+        static const std::int64_t origin;
+
+
+        /** Buffers stock mutex */
+        static std::mutex buffer_mutex;
+
+        /** Buffers stock */
+        static std::forward_list<Profiler::Buffer> buffer_stock;
+
+        /** Number of buffers */
+        static std::uint32_t buffers;
+
+        /** Buffer of the current thread */
+        static thread_local Profiler::Buffer *buffer;
+
+
+        /** Frame marks time stamps */
+        static std::int64_t frame_mark[];
+
+        /** Total of frame marks */
+        static std::size_t frames;
+
+
+        // Static methods
+
+        /** Get the buffer of the current thread */
+        static Profiler::Buffer *getBuffer();
+
+
+    public:
+        // Constructors
+
+        /** Disable the default constructor */
+        Profiler() = delete;
+
+
+        // Static getters
+
+        /** Get the enabled status */
+        static bool isEnabled();
+
+        /** Get the current time stamp in nanoseconds */
+        static std::int64_t now();
+
+
+        // Static setters
+
+        /** Set the enabled status */
+        static void setEnabled(const bool &status);
+
+
+        // Static methods
+
+        /** Record an event */
+        static void record(const char *const name, const std::int64_t &start, const std::int64_t &end, const std::uint32_t &count = 0U);
+
+        /** Mark the start of a frame, only from the main thread */
+        static void markFrame();
+
+        /** Dump the events of the last frames, or all the stored events for zero frames, as a Chrome trace JSON */
+        static bool dump(const std::string &path, const std::size_t &last_frames = 0U);
+};
+
+#endif // __PROFILER_HPP_
\ No newline at end of file
@@ -0,0 +1,445 @@
+#include "benchmarkscene.hpp"
+
+#include "../model/loader/modelloader.hpp"
+#include "../profiler/profiler.hpp"
+#include "../dirsep.h"
+
+#include <glm/geometric.hpp>
+#include <glm/common.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+
+#include <algorithm>
+#include <cmath>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+
+// Private methods
+
+// Add a model measuring its load time
+std::size_t BenchmarkScene::addTimedModel(const std::string &path, const std::size_t &program_id) {
+    // Load the model
+    const double start = glfwGetTime();
+    const std::size_t id = addModel(path, program_id);
+    const double time = (glfwGetTime() - start) * 1000.0;
+
+    // Store the load phase with the model name and the memory growth
+    const Model *const model = getModel(id);
+    addLoadPhase("model: " + model->getName(), time);
+    load_memory_growth = std::max(load_memory_growth, model->getLoadMemory());
+
+    // Check the model status
+    if (!model->isOpen()) {
+        std::cerr << "error: could not load the benchmark model `" << path << "'" << std::endl;
+    }
+
+    return id;
+}
+
+// Create the orbit camera path around the origin
+void BenchmarkScene::createOrbitPath(const float &radius, const float &height) {
+    // Sample a full turn
+    const int samples = 64;
+    camera_path.clear();
+    for (int i = 0; i <= samples; i++) {
+        const float angle = 6.28318530718F * static_cast<float>(i) / static_cast<float>(samples);
+        BenchmarkScene::KeyFrame key_frame;
+        key_frame.position  = glm::vec3(radius * std::sin(angle), height, radius * std::cos(angle));
+        key_frame.direction = -key_frame.position;
+        camera_path.push_back(key_frame);
+    }
+}
+
+// Move the active camera to the frame position of the path
+void BenchmarkScene::moveCamera(const int &frame) {
+    // Check the path and camera
+    if (camera_path.empty() || (active_camera == nullptr)) {
+        return;
+    }
+
+    // Single key frame path
+    if (camera_path.size() == 1U) {
+        active_camera->setPosition(camera_path[0U].position);
+        active_camera->setDirection(camera_path[0U].direction);
+        return;
+    }
+
+    // Interpolate between the surrounding key frames
+    const float t = static_cast<float>(frame) / static_cast<float>(frames > 1 ? frames - 1 : 1) * static_cast<float>(camera_path.size() - 1U);
+    const std::size_t index = std::min(static_cast<std::size_t>(t), camera_path.size() - 2U);
+    const float alpha = t - static_cast<float>(index);
+    const BenchmarkScene::KeyFrame &from = camera_path[index];
+    const BenchmarkScene::KeyFrame &to   = camera_path[index + 1U];
+
+    active_camera->setPosition(glm::mix(from.position, to.position, alpha));
+    active_camera->setDirection(glm::mix(glm::normalize(from.direction), glm::normalize(to.direction), alpha));
+}
+
+
+// Private static methods
+
+// Get the peak and current resident set size in kilobytes
+void BenchmarkScene::getMemoryUsage(long &peak, long &current) {
+    peak    = 0L;
+    current = 0L;
+
+#ifndef _WIN32
+    // Peak resident set size
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        peak = usage.ru_maxrss;
+    }
+
+    // Current resident set size
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0U, 6U, "VmRSS:") == 0) {
+            std::istringstream(line.substr(6U)) >> current;
+            break;
+        }
+    }
+#endif
+}
+
+// Write the percentiles as a JSON object
+void BenchmarkScene::writePercentiles(std::ostream &file, const FrameStats::Percentiles &percentiles) {
+    file << "{\"p50\": " << percentiles.p50 << ", \"p95\": " << percentiles.p95 << ", \"p99\": " << percentiles.p99 << ", \"max\": " << percentiles.max << "}";
+}
+
+// Escape the quotes, backslashes and control characters of a JSON string
+std::string BenchmarkScene::escapeJSON(const std::string &str) {
+    std::ostringstream escaped;
+    for (const char &character : str) {
+        switch (character) {
+            case '"':  escaped << "\\\""; break;
+            case '\\': escaped << "\\\\"; break;
+            case '\n': escaped << "\\n"; break;
+            case '\r': escaped << "\\r"; break;
+            case '\t': escaped << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(character) < 0x20U) {
+                    escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(character) << std::dec;
+                }
+                else {
+                    escaped << character;
+                }
+        }
+    }
+
+    return escaped.str();
+}
+
+
+// Constructor
+
+// Benchmark scene constructor
+BenchmarkScene::BenchmarkScene(const std::string &title, const int &width, const int &height, const bool &headless) :
+    // Scene
+    Scene(title, width, height, 3, 3, headless),
+
+    // Default benchmark
+    scenario_name("custom"),
+    frames(600),
+    warmup_frames(30),
+    load_memory_growth(0L) {
+    // Measure the raw throughput
+    if (window != nullptr) {
+        setVSyncEnabled(false);
+    }
+}
+
+
+// Getters
+
+// Get the number of measured frames
+int BenchmarkScene::getFrames() const {
+    return frames;
+}
+
+
+// Setters
+
+// Set the number of measured frames, limited to the stored frame times
+void BenchmarkScene::setFrames(const int &number) {
+    if (number > FrameStats::FRAMES) {
+        std::cerr << "error: the benchmark frames are limited to " << FrameStats::FRAMES << ", " << number << " requested" << std::endl;
+    }
+
+    frames = glm::clamp(number, 1, FrameStats::FRAMES);
+}
+
+// Load the camera path from a file with a position and a direction per line
+bool BenchmarkScene::setCameraPath(const std::string &path) {
+    // Open the camera path file
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "error: could not open the camera path file `" << path << "'" << std::endl;
+        return false;
+    }
+
+    // Read the key frames
+    std::vector<BenchmarkScene::KeyFrame> key_frames;
+    std::string line;
+    while (std::getline(file, line)) {
+        // Skip empty lines and comments
+        if (line.empty() || (line[0U] == '#')) {
+            continue;
+        }
+
+        // Parse the position and direction
+        BenchmarkScene::KeyFrame key_frame;
+        std::istringstream stream(line);
+        if (!(stream >> key_frame.position.x >> key_frame.position.y >> key_frame.position.z >> key_frame.direction.x >> key_frame.direction.y >> key_frame.direction.z)) {
+            std::cerr << "error: invalid camera path key frame `" << line << "'" << std::endl;
+            return false;
+        }
+
+        key_frames.push_back(key_frame);
+    }
+
+    // Check the key frames
+    if (key_frames.empty()) {
+        std::cerr << "error: the camera path file `" << path << "' has no key frames" << std::endl;
+        return false;
+    }
+
+    camera_path = key_frames;
+    return true;
+}
+
+
+// Methods
+
+// Add a load phase time in milliseconds
+void BenchmarkScene::addLoadPhase(const std::string &name, const double &time) {
+    load_phase.push_back(std::pair<std::string, double>(name, time));
+}
+
+// Setup the scenario with the models directory and the geometry pass programs
+bool BenchmarkScene::setupScenario(const BenchmarkScene::Scenario &scenario, const std::string &model_path, const std::size_t &normal_program, const std::size_t &parallax_program, const std::string &mesh_path) {
+    PROFILE_ZONE("BenchmarkScene::setupScenario");
+
+    // Scene models paths
+    const std::string suzanne  = model_path + "suzanne"  + DIR_SEP + "suzanne.obj";
+    const std::string box      = model_path + "box"      + DIR_SEP + "box.obj";
+    const std::string nanosuit = model_path + "nanosuit" + DIR_SEP + "nanosuit.obj";
+
+    switch (scenario) {
+        // Grid of alternating models
+        case BenchmarkScene::MANY_MODELS: {
+            scenario_name = "many_models";
+            std::vector<Model *> model;
+            std::vector<glm::vec3> position;
+            for (int i = 0; i < 64; i++) {
+                const std::size_t id = addTimedModel((i % 2) == 0 ? suzanne : box, (i % 2) == 0 ? 0U : normal_program);
+                model.push_back(getModel(id));
+                position.push_back(glm::vec3(static_cast<float>(i % 8) - 3.5F, 0.0F, static_cast<float>(i / 8) - 3.5F) * 0.6F);
+            }
+
+            // Place the grid at once
+            Model::setTransforms(model, position, std::vector<glm::quat>(model.size(), glm::quat()), std::vector<glm::vec3>(model.size(), glm::vec3(0.4F)));
+            createOrbitPath(4.5F, 2.0F);
+            break;
+        }
+
+        // Default models lit by a ring of point lights
+        case BenchmarkScene::MANY_LIGHTS: {
+            scenario_name = "many_lights";
+            addTimedModel(nanosuit, normal_program);
+            Model *model = getModel(addTimedModel(suzanne, 0U));
+            model->setScale(glm::vec3(0.45F));
+            model->setPosition(glm::vec3(0.6F, 0.225F, 0.0F));
+            model = getModel(addTimedModel(box, parallax_program));
+            model->setScale(glm::vec3(0.45F));
+            model->setPosition(glm::vec3(0.6F, -0.225F, 0.0F));
+            for (int i = 0; i < 64; i++) {
+                const float angle = 6.28318530718F * static_cast<float>(i) / 64.0F;
+                Light *const light = getLight(addLight(Light::POINT));
+                light->setPosition(glm::vec3(std::sin(angle), 0.15F * static_cast<float>(i % 8) - 0.5F, std::cos(angle)) * 0.9F);
+                light->setAttenuation(glm::vec3(1.0F, 4.5F, 75.0F));
+                light->setAmbientLevel(0.0F);
+                light->setDiffuseColor(glm::vec3(0.5F + 0.5F * std::sin(angle), 0.5F + 0.5F * std::cos(angle), 0.5F));
+            }
+            createOrbitPath(2.0F, 0.5F);
+            break;
+        }
+
+        // Parallax mapped boxes filling the screen
+        case BenchmarkScene::PARALLAX_HEAVY: {
+            scenario_name = "parallax_heavy";
+            for (int i = 0; i < 9; i++) {
+                const std::size_t id = addTimedModel(box, parallax_program);
+                getModel(id)->setPosition(glm::vec3(static_cast<float>(i % 3) - 1.0F, static_cast<float>(i / 3) - 1.0F, 0.0F));
+            }
+            createOrbitPath(1.8F, 0.3F);
+            break;
+        }
+
+        // A single large mesh
+        case BenchmarkScene::LARGE_MESH: {
+            scenario_name = "large_mesh";
+            addTimedModel(mesh_path.empty() ? nanosuit : mesh_path, normal_program);
+            createOrbitPath(2.0F, 0.5F);
+            break;
+        }
+    }
+
+    // Check the models status
+    for (const std::pair<std::size_t, std::pair<Model *, std::size_t> > &model_data : model_stock) {
+        if (!model_data.second.first->isOpen()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Render the benchmark frames and write the JSON report
+bool BenchmarkScene::run(const std::string &report_path) {
+    // Check the window status
+    if (window == nullptr) {
+        std::cerr << "error: there is no window" << std::endl;
+        return false;
+    }
+
+    // Warm up the caches, shaders and GPU timers
+    for (int i = 0; i < warmup_frames; i++) {
+        moveCamera(0);
+        renderFrame();
+        if (!headless) {
+            glfwSwapBuffers(window);
+        }
+    }
+
+    // Measured frames accumulators
+    frame_stats.reset();
+    double geometry_time   = 0.0;
+    double background_time = 0.0;
+    double lights_time     = 0.0;
+    double composite_time  = 0.0;
+    std::size_t calls      = 0U;
+    double overdraw_saved  = 0.0;
+
+    // Render the measured frames
+    const double start = glfwGetTime();
+    for (int i = 0; i < frames; i++) {
+        moveCamera(i);
+        renderFrame();
+        if (!headless) {
+            glfwPollEvents();
+            glfwSwapBuffers(window);
+        }
+
+        // Accumulate the passes GPU times and draw calls
+        geometry_time   += geometry_timer->getElapsed();
+        background_time += background_timer->getElapsed();
+        composite_time  += composite_timer->getElapsed();
+        for (const std::pair<const std::size_t, GPUTimer *> &timer_data : light_timer) {
+            lights_time += timer_data.second->getElapsed();
+        }
+        calls += draw_calls;
+        overdraw_saved += getOverdrawSaved();
+    }
+    glFinish();
+    const double total = glfwGetTime() - start;
+
+    // Open the report file
+    std::ofstream file(report_path);
+    if (!file.is_open()) {
+        std::cerr << "error: could not open the benchmark report file `" << report_path << "'" << std::endl;
+        return false;
+    }
+
+    // Get the memory usage
+    long peak_rss;
+    long rss;
+    BenchmarkScene::getMemoryUsage(peak_rss, rss);
+
+    // Scenario and context
+    const double count = static_cast<double>(frames);
+    file << "{" << std::endl;
+    file << "  \"scenario\": \"" << BenchmarkScene::escapeJSON(scenario_name) << "\"," << std::endl;
+    file << "  \"renderer\": \"" << BenchmarkScene::escapeJSON(reinterpret_cast<const char *>(Scene::getOpenGLRenderer())) << "\"," << std::endl;
+    file << "  \"resolution\": [" << width << ", " << height << "]," << std::endl;
+    file << "  \"render_scale\": " << Scene::getRenderScale() << "," << std::endl;
+    file << "  \"headless\": " << (headless ? "true" : "false") << "," << std::endl;
+    file << "  \"frames\": " << frames << "," << std::endl;
+    file << "  \"total_s\": " << total << "," << std::endl;
+
+    // Load phases
+    file << "  \"load_ms\": {";
+    for (std::size_t i = 0U; i < load_phase.size(); i++) {
+        file << (i == 0U ? "" : ", ") << "\"" << BenchmarkScene::escapeJSON(load_phase[i].first) << "\": " << load_phase[i].second;
+    }
+    file << "}," << std::endl;
+
+    // Frame times percentiles
+    file << "  \"cpu_ms\": ";
+    BenchmarkScene::writePercentiles(file, frame_stats.getCPUPercentiles());
+    file << "," << std::endl << "  \"gpu_ms\": ";
+    BenchmarkScene::writePercentiles(file, frame_stats.getGPUPercentiles());
+    file << "," << std::endl;
+    file << "  \"hitches\": " << frame_stats.getHitches() << "," << std::endl;
+
+    // Average passes GPU times
+    file << "  \"passes_ms\": {\"geometry\": " << geometry_time / count << ", \"background\": " << background_time / count << ", \"lights\": " << lights_time / count << ", \"composite\": " << composite_time / count << "}," << std::endl;
+
+    // Draw calls, models, lights and memory
+    file << "  \"draw_calls\": " << static_cast<double>(calls) / count << "," << std::endl;
+    file << "  \"depth_prepass\": " << (depth_prepass ? "true" : "false") << "," << std::endl;
+    file << "  \"split_streams\": " << (ModelLoader::getVertexLayout() == ModelLoader::SPLIT ? "true" : "false") << "," << std::endl;
+    file << "  \"overdraw_saved\": " << overdraw_saved / count << "," << std::endl;
+    file << "  \"models\": " << model_stock.size() << "," << std::endl;
+    file << "  \"lights\": " << light_stock.size() << "," << std::endl;
+    file << "  \"memory_kb\": {\"peak_rss\": " << peak_rss << ", \"load_memory_growth\": " << load_memory_growth << ", \"rss\": " << rss << "}" << std::endl;
+    file << "}" << std::endl;
+
+    // Report the benchmark
+    const FrameStats::Percentiles cpu = frame_stats.getCPUPercentiles();
+    const FrameStats::Percentiles gpu = frame_stats.getGPUPercentiles();
+    std::cout << "benchmark: " << scenario_name << ", " << frames << " frames in " << total << "s, cpu p50 " << cpu.p50 << "ms p99 " << cpu.p99 << "ms, gpu p50 " << gpu.p50 << "ms p99 " << gpu.p99 << "ms" << std::endl;
+    std::cout << "benchmark: report written to `" << report_path << "'" << std::endl;
+    return true;
+}
+
+// Render main loop
+void BenchmarkScene::mainLoop() {
+    run("objviewer_bench.json");
+}
+
+
+// Static methods
+
+// Get the scenario from its name, false if unknown
+bool BenchmarkScene::getScenario(const std::string &name, BenchmarkScene::Scenario &scenario) {
+    if (name == "many_models") {
+        scenario = BenchmarkScene::MANY_MODELS;
+    }
+    else if (name == "many_lights") {
+        scenario = BenchmarkScene::MANY_LIGHTS;
+    }
+    else if (name == "parallax_heavy") {
+        scenario = BenchmarkScene::PARALLAX_HEAVY;
+    }
+    else if (name == "large_mesh") {
+        scenario = BenchmarkScene::LARGE_MESH;
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+
+// Destructor
+
+// Benchmark scene destructor
+BenchmarkScene::~BenchmarkScene() {}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#ifndef __BENCHMARK_SCENE_HPP_
+#define __BENCHMARK_SCENE_HPP_
+
+#include "scene.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <string>
+#include <vector>
+#include <utility>
+
+
+class BenchmarkScene : public Scene {
+    public:
+        // Enumerations
+        enum Scenario {
+            /** Grid of small models */
+            MANY_MODELS,
+
+            /** Few models lit by many point lights */
+            MANY_LIGHTS,
+
+            /** Screen filled with parallax mapped models */
+            PARALLAX_HEAVY,
+
+            /** Single model with a large mesh */
+            LARGE_MESH
+        };
+
+
+    private:
+        // Structs
+
+        /** Camera path key frame */
+        struct KeyFrame {
+            /** Camera position */
+            glm::vec3 position;
+
+            /** Camera direction */
+            glm::vec3 direction;
+        };
+
+
+        // Attributes
+
+        /** Scenario name */
+        std::string scenario_name;
+
+        /** Number of measured frames */
+        int frames;
+
+        /** Number of warm up frames */
+        int warmup_frames;
+
+        /** Camera path key frames */
+        std::vector<BenchmarkScene::KeyFrame> camera_path;
+
+        /** Load phases and their time in milliseconds */
+        std::vector<std::pair<std::string, double> > load_phase;
+
+        /** Largest sampled resident set size growth of a model load in kilobytes */
+        long load_memory_growth;
+
+
+        // Methods
+
+        /** Add a model measuring its load time */
+        std::size_t addTimedModel(const std::string &path, const std::size_t &program_id);
+
+        /** Create the orbit camera path around the origin */
+        void createOrbitPath(const float &radius, const float &height);
+
+        /** Move the active camera to the frame position of the path */
+        void moveCamera(const int &frame);
+
+
+        // Static methods
+
+        /** Get the peak and current resident set size in kilobytes */
+        static void getMemoryUsage(long &peak, long &current);
+
+        /** Write the percentiles as a JSON object */
+        static void writePercentiles(std::ostream &file, const FrameStats::Percentiles &percentiles);
+
+        /** Escape the quotes, backslashes and control characters of a JSON string */
+        static std::string escapeJSON(const std::string &str);
+
+
+    public:
+        // Constructor
+
+        /** Benchmark scene constructor */
+        BenchmarkScene(const std::string &title, const int &width = 1280, const int &height = 720, const bool &headless = false);
+
+
+        // Getters
+
+        /** Get the number of measured frames */
+        int getFrames() const;
+
+
+        // Setters
+
+        /** Set the number of measured frames, limited to the stored frame times */
+        void setFrames(const int &number);
+
+        /** Load the camera path from a file with a position and a direction per line */
+        bool setCameraPath(const std::string &path);
+
+
+        // Methods
+
+        /** Add a load phase time in milliseconds */
+        void addLoadPhase(const std::string &name, const double &time);
+
+        /** Setup the scenario with the models directory and the geometry pass programs */
+        bool setupScenario(const BenchmarkScene::Scenario &scenario, const std::string &model_path, const std::size_t &normal_program, const std::size_t &parallax_program, const std::string &mesh_path = "");
+
+        /** Render the benchmark frames and write the JSON report */
+        bool run(const std::string &report_path);
+
+        /** Render main loop */
+        void mainLoop();
+
+
+        // Static methods
+
+        /** Get the scenario from its name, false if unknown */
+        static bool getScenario(const std::string &name, BenchmarkScene::Scenario &scenario);
+
+
+        // Destructor
+
+        /** Benchmark scene destructor */
+        virtual ~BenchmarkScene();
+};
+
+#endif // __BENCHMARK_SCENE_HPP_
\ No newline at end of file
@@ -28,25 +28,32 @@ float Camera::zoom_factor = 1.0625F;
 
 // Private methods
 
-// updateViewMatrix
-void Camera::updateViewMatrix() {
-    view_mat = glm::lookAt(position, position + front, glm::cross(right, front));
+// Update the view matrix if it is outdated
+void Camera::updateViewMatrix() const {
+    if (view_outdated) {
+        view_mat = glm::lookAt(position, position + front, glm::cross(right, front));
+        view_outdated = false;
+    }
 }
 
-// Update projection matrices
-void Camera::updateProjectionMatrices() {
-    // Auxiliar values
-    const float aspect = width / height;
-    const float ratio = std::atan(fov / 2.0F);
-    const float distance = glm::length(position);
+// Update the orthogonal projection matrix if it is outdated
+void Camera::updateOrthogonalMatrix() const {
+    if (orthogonal_outdated) {
+        // Orthogonal limits from the distance to the origin
+        const float y = std::atan(fov / 2.0F) * glm::length(position);
+        const float x = y * width / height;
 
-    // Orthogonal limits
-    const float y = ratio * distance;
-    const float x = y * aspect;
+        orthogonal_mat = glm::ortho(-x, x, -y, y, near, far);
+        orthogonal_outdated = false;
+    }
+}
 
-    // Projection matrices
-    orthogonal_mat = glm::ortho(-x, x, -y, y, near, far);
-    perspective_mat = glm::perspective(fov, aspect, near, far);
+// Update the perspective projection matrix if it is outdated
+void Camera::updatePerspectiveMatrix() const {
+    if (perspective_outdated) {
+        perspective_mat = glm::perspective(fov, width / height, near, far);
+        perspective_outdated = false;
+    }
 }
 
 
@@ -109,22 +116,25 @@ glm::vec2 Camera::getClipping() const {
 
 // Get the view matrix
 glm::mat4 Camera::getViewMatrix() const {
+    updateViewMatrix();
     return view_mat;
 }
 
 // Get the orthogonal projection matrix
 glm::mat4 Camera::getOrthogonalMatrix() const {
+    updateOrthogonalMatrix();
     return orthogonal_mat;
 }
 
 // Get the perspective projection matrix
 glm::mat4 Camera::getPerspectiveMatrix() const {
+    updatePerspectiveMatrix();
     return perspective_mat;
 }
 
 // Get the current projection matrix
 glm::mat4 Camera::getProjectionMatrix() const {
-    return orthogonal ? orthogonal_mat : perspective_mat;
+    return orthogonal ? getOrthogonalMatrix() : getPerspectiveMatrix();
 }
 
 
@@ -139,15 +149,15 @@ void Camera::setOrthogonal(const bool &status) {
 // Set position
 void Camera::setPosition(const glm::vec3 &new_position) {
     position = new_position;
-    updateViewMatrix();
-    updateProjectionMatrices();
+    view_outdated = true;
+    orthogonal_outdated = true;
 }
 
 // Set look direction
 void Camera::setDirection(const glm::vec3 &new_direction) {
     front = glm::normalize(new_direction);
     right = glm::cross(front, up);
-    updateViewMatrix();
+    view_outdated = true;
 }
 
 // Set look angles
@@ -169,22 +179,23 @@ void Camera::setRotation(const glm::vec3 &angle) {
     // Update right vector
     right = glm::normalize(glm::cross(front, up));
 
-    // Update view matrix
-    updateViewMatrix();
+    // Outdate the view matrix
+    view_outdated = true;
 }
 
 // Set up vector
 void Camera::setUp(const glm::vec3 &direction) {
     up = glm::normalize(direction);
     right = glm::normalize(glm::cross(front, up));
-    updateViewMatrix();
+    view_outdated = true;
 }
 
 
 // Set field of view
 void Camera::setFOV(const float &new_fov) {
     fov = glm::radians(new_fov);
-    updateProjectionMatrices();
+    orthogonal_outdated = true;
+    perspective_outdated = true;
 }
 
 // Set resolution
@@ -198,15 +209,17 @@ void Camera::setResolution(const glm::vec2 &resolution) {
         height = 1.0F;
     }
 
-    // Update matrices
-    updateProjectionMatrices();
+    // Outdate the projection matrices
+    orthogonal_outdated = true;
+    perspective_outdated = true;
 }
 
 // Set clipping
 void Camera::setClipping(const glm::vec2 &clipping) {
     near = clipping.x;
     far = clipping.y;
-    updateProjectionMatrices();
+    orthogonal_outdated = true;
+    perspective_outdated = true;
 }
 
 
@@ -229,9 +242,10 @@ void Camera::reset() {
     yaw   = -90.0F;
     pitch = 0.0F;
 
-    // Update matrices
-    updateViewMatrix();
-    updateProjectionMatrices();
+    // Outdate all matrices
+    view_outdated = true;
+    orthogonal_outdated = true;
+    perspective_outdated = true;
 }
 
 
@@ -249,8 +263,8 @@ void Camera::bind(GLSLProgram *const program) const {
     program->setUniform("u_up_dir",         up);
     program->setUniform("u_view_dir",       front);
     program->setUniform("u_view_pos",       position);
-    program->setUniform("u_view_mat",       view_mat);
-    program->setUniform("u_projection_mat", orthogonal ? orthogonal_mat : perspective_mat);
+    program->setUniform("u_view_mat",       getViewMatrix());
+    program->setUniform("u_projection_mat", getProjectionMatrix());
 }
 
 
@@ -269,21 +283,23 @@ void Camera::travell(const Camera::Movement &direction, const double &time) {
         case BACK:  position -= glm::normalize(glm::cross(up, right)) * distance; break;
     }
 
-    // Update matrices
-    updateViewMatrix();
-    updateProjectionMatrices();
+    // Outdate the matrices depending on the position
+    view_outdated = true;
+    orthogonal_outdated = true;
 }
 
 // Translate the camera
 void Camera::translate(const glm::vec3 &delta) {
     position += delta;
-    updateViewMatrix();
+    view_outdated = true;
+    orthogonal_outdated = true;
 }
 
 // Apply zoom
 void Camera::zoom(const double &direction) {
     fov = direction > 0 ? fov / Camera::zoom_factor : fov * Camera::zoom_factor;
-    updateProjectionMatrices();
+    orthogonal_outdated = true;
+    perspective_outdated = true;
 }
 
 
@@ -302,8 +318,8 @@ void Camera::rotate(const glm::vec2 &delta) {
     // Update right vector
     right = glm::normalize(glm::cross(front, up));
 
-    // Update view matrix
-    updateViewMatrix();
+    // Outdate the view matrix
+    view_outdated = true;
 }
 
 
@@ -45,13 +45,23 @@ class Camera {
 
 
         /** View matrix */
-        glm::mat4 view_mat;
+        mutable glm::mat4 view_mat;
 
         /** Orthogonal projection matrix */
-        glm::mat4 orthogonal_mat;
+        mutable glm::mat4 orthogonal_mat;
 
         /** Perspective projection matrix */
-        glm::mat4 perspective_mat;
+        mutable glm::mat4 perspective_mat;
+
+
+        /** Outdated view matrix status */
+        mutable bool view_outdated;
+
+        /** Outdated orthogonal projection matrix status */
+        mutable bool orthogonal_outdated;
+
+        /** Outdated perspective projection matrix status */
+        mutable bool perspective_outdated;
 
 
         /** Rotation  pitch */
@@ -69,11 +79,14 @@ class Camera {
 
         // Methods
 
-        /** updateViewMatrix */
-        void updateViewMatrix();
+        /** Update the view matrix if it is outdated */
+        void updateViewMatrix() const;
+
+        /** Update the orthogonal projection matrix if it is outdated */
+        void updateOrthogonalMatrix() const;
 
-        /** Update projection matrices */
-        void updateProjectionMatrices();
+        /** Update the perspective projection matrix if it is outdated */
+        void updatePerspectiveMatrix() const;
 
 
         // Static attributes
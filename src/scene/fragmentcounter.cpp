@@ -0,0 +1,59 @@
+#include "fragmentcounter.hpp"
+
+
+// Constructor
+
+// Fragment counter constructor
+FragmentCounter::FragmentCounter() :
+    // Default statuses
+    pending{false, false},
+    current(0),
+    samples(0U) {
+    // Generate the queries
+    glGenQueries(2, query);
+}
+
+
+// Getters
+
+// Get the last available number of samples that passed the depth test
+GLuint64 FragmentCounter::getSamples() const {
+    return samples;
+}
+
+
+// Methods
+
+// Begin the samples passed query and collect the result of the previous one without stalling
+void FragmentCounter::begin() {
+    // Collect the result issued two frames ago if it is available
+    if (pending[current]) {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(query[current], GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if (available != GL_FALSE) {
+            glGetQueryObjectui64v(query[current], GL_QUERY_RESULT, &samples);
+        }
+
+        pending[current] = false;
+    }
+
+    // Begin the query
+    glBeginQuery(GL_SAMPLES_PASSED, query[current]);
+}
+
+// End the samples passed query
+void FragmentCounter::end() {
+    // End the query and swap to the next one
+    glEndQuery(GL_SAMPLES_PASSED);
+    pending[current] = true;
+    current ^= 1;
+}
+
+
+// Destructor
+
+// Fragment counter destructor
+FragmentCounter::~FragmentCounter() {
+    glDeleteQueries(2, query);
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef __FRAGMENT_COUNTER_HPP_
+#define __FRAGMENT_COUNTER_HPP_
+
+#include "../glad/glad.h"
+
+
+class FragmentCounter {
+    private:
+        // Attributes
+
+        /** Double buffered samples passed queries */
+        GLuint query[2];
+
+        /** Pending result status of each query */
+        bool pending[2];
+
+        /** Current query index */
+        int current;
+
+        /** Last available number of samples that passed the depth test */
+        GLuint64 samples;
+
+
+        // Constructors
+
+        /** Disable the default copy constructor */
+        FragmentCounter(const FragmentCounter &) = delete;
+
+        /** Disable the assignation operator */
+        FragmentCounter &operator=(const FragmentCounter &) = delete;
+
+
+    public:
+        // Constructor
+
+        /** Fragment counter constructor */
+        FragmentCounter();
+
+
+        // Getters
+
+        /** Get the last available number of samples that passed the depth test */
+        GLuint64 getSamples() const;
+
+
+        // Methods
+
+        /** Begin the samples passed query and collect the result of the previous one without stalling */
+        void begin();
+
+        /** End the samples passed query */
+        void end();
+
+
+        // Destructor
+
+        /** Fragment counter destructor */
+        virtual ~FragmentCounter();
+};
+
+#endif // __FRAGMENT_COUNTER_HPP_
\ No newline at end of file
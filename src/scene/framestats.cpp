@@ -0,0 +1,150 @@
+#include "framestats.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include <fstream>
+#include <iostream>
+
+
+// Private static const attributes
+
+// Frame time ratio over the median considered a hitch
+const float FrameStats::HITCH_RATIO = 2.0F;
+
+// Frames between median updates
+const int FrameStats::MEDIAN_PERIOD = 64;
+
+
+// Private static methods
+
+// Get the percentiles of the given frame times
+FrameStats::Percentiles FrameStats::getPercentiles(const float *const time, const int &frames) {
+    // Empty percentiles
+    FrameStats::Percentiles percentiles = {0.0F, 0.0F, 0.0F, 0.0F};
+    if (frames == 0) {
+        return percentiles;
+    }
+
+    // Sort a copy of the frame times
+    std::vector<float> sorted(time, time + frames);
+    std::sort(sorted.begin(), sorted.end());
+
+    // Nearest rank percentiles
+    percentiles.p50 = sorted[(frames - 1) * 50 / 100];
+    percentiles.p95 = sorted[(frames - 1) * 95 / 100];
+    percentiles.p99 = sorted[(frames - 1) * 99 / 100];
+    percentiles.max = sorted.back();
+    return percentiles;
+}
+
+
+// Constructor
+
+// Frame stats constructor
+FrameStats::FrameStats() :
+    // Empty ring buffers
+    frames(0),
+    next(0),
+
+    // No hitches
+    hitches(0U),
+    median(0.0F) {}
+
+
+// Getters
+
+// Get the number of stored frames
+int FrameStats::getFrames() const {
+    return frames;
+}
+
+// Get the ring buffer offset of the oldest frame
+int FrameStats::getOffset() const {
+    return frames < FrameStats::FRAMES ? 0 : next;
+}
+
+// Get the CPU frame times ring buffer
+const float *FrameStats::getCPUTimes() const {
+    return cpu_time;
+}
+
+// Get the GPU frame times ring buffer
+const float *FrameStats::getGPUTimes() const {
+    return gpu_time;
+}
+
+// Get the CPU frame time percentiles
+FrameStats::Percentiles FrameStats::getCPUPercentiles() const {
+    return FrameStats::getPercentiles(cpu_time, frames);
+}
+
+// Get the GPU frame time percentiles
+FrameStats::Percentiles FrameStats::getGPUPercentiles() const {
+    return FrameStats::getPercentiles(gpu_time, frames);
+}
+
+// Get the number of hitches
+std::size_t FrameStats::getHitches() const {
+    return hitches;
+}
+
+
+// Methods
+
+// Record the CPU and GPU times of a frame in milliseconds
+void FrameStats::record(const double &cpu, const double &gpu) {
+    // Store the frame
+    cpu_time[next] = static_cast<float>(cpu);
+    gpu_time[next] = static_cast<float>(gpu);
+    next = (next + 1) % FrameStats::FRAMES;
+    if (frames < FrameStats::FRAMES) {
+        frames++;
+    }
+
+    // Count the frames bound by the slowest processor over the hitch ratio of the median
+    const float frame_time = static_cast<float>(std::max(cpu, gpu));
+    if ((median > 0.0F) && (frame_time > median * FrameStats::HITCH_RATIO)) {
+        hitches++;
+    }
+
+    // Update the median periodically
+    if ((next % FrameStats::MEDIAN_PERIOD) == 0) {
+        median = std::max(getCPUPercentiles().p50, getGPUPercentiles().p50);
+    }
+}
+
+// Reset the recorded frames and hitches
+void FrameStats::reset() {
+    frames = 0;
+    next = 0;
+    hitches = 0U;
+    median = 0.0F;
+}
+
+// Write the recorded frames and their percentiles to a CSV file
+bool FrameStats::snapshot(const std::string &path) const {
+    // Open the snapshot file
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "error: could not open the frame times snapshot file `" << path << "'" << std::endl;
+        return false;
+    }
+
+    // Write the percentiles as comments
+    const FrameStats::Percentiles cpu = getCPUPercentiles();
+    const FrameStats::Percentiles gpu = getGPUPercentiles();
+    file << "# frames: " << frames << ", hitches: " << hitches << std::endl;
+    file << "# cpu_ms p50: " << cpu.p50 << ", p95: " << cpu.p95 << ", p99: " << cpu.p99 << ", max: " << cpu.max << std::endl;
+    file << "# gpu_ms p50: " << gpu.p50 << ", p95: " << gpu.p95 << ", p99: " << gpu.p99 << ", max: " << gpu.max << std::endl;
+
+    // Write the frames from the oldest
+    file << "frame,cpu_ms,gpu_ms" << std::endl;
+    for (int i = 0, index = getOffset(); i < frames; i++, index = (index + 1) % FrameStats::FRAMES) {
+        file << i << "," << cpu_time[index] << "," << gpu_time[index] << std::endl;
+    }
+
+    // Report the snapshot
+    std::cout << "frame times: " << frames << " frames written to `" << path << "'" << std::endl;
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#ifndef __FRAME_STATS_HPP_
+#define __FRAME_STATS_HPP_
+
+#include <string>
+
+
+class FrameStats {
+    public:
+        // Static const attributes
+
+        /** Number of frames of the ring buffer */
+        static const int FRAMES = 1024;
+
+
+        // Structs
+
+        /** Frame time percentiles in milliseconds */
+        struct Percentiles {
+            /** Median */
+            float p50;
+
+            /** 95th percentile */
+            float p95;
+
+            /** 99th percentile */
+            float p99;
+
+            /** Maximum */
+            float max;
+        };
+
+
+    private:
+        // Attributes
+
+        /** CPU frame times ring buffer in milliseconds */
+        float cpu_time[FrameStats::FRAMES];
+
+        /** GPU frame times ring buffer in milliseconds */
+        float gpu_time[FrameStats::FRAMES];
+
+        /** Number of stored frames */
+        int frames;
+
+        /** Next frame index */
+        int next;
+
+
+        /** Frames over the hitch ratio of the median */
+        std::size_t hitches;
+
+        /** Median frame time for the hitch detection */
+        float median;
+
+
+        // Static const attributes
+
+        /** Frame time ratio over the median considered a hitch */
+        static const float HITCH_RATIO;
+
+        /** Frames between median updates */
+        static const int MEDIAN_PERIOD;
+
+
+        // Static methods
+
+        /** Get the percentiles of the given frame times */
+        static FrameStats::Percentiles getPercentiles(const float *const time, const int &frames);
+
+
+    public:
+        // Constructor
+
+        /** Frame stats constructor */
+        FrameStats();
+
+
+        // Getters
+
+        /** Get the number of stored frames */
+        int getFrames() const;
+
+        /** Get the ring buffer offset of the oldest frame */
+        int getOffset() const;
+
+        /** Get the CPU frame times ring buffer */
+        const float *getCPUTimes() const;
+
+        /** Get the GPU frame times ring buffer */
+        const float *getGPUTimes() const;
+
+        /** Get the CPU frame time percentiles */
+        FrameStats::Percentiles getCPUPercentiles() const;
+
+        /** Get the GPU frame time percentiles */
+        FrameStats::Percentiles getGPUPercentiles() const;
+
+        /** Get the number of hitches */
+        std::size_t getHitches() const;
+
+
+        // Methods
+
+        /** Record the CPU and GPU times of a frame in milliseconds */
+        void record(const double &cpu, const double &gpu);
+
+        /** Reset the recorded frames and hitches */
+        void reset();
+
+        /** Write the recorded frames and their percentiles to a CSV file */
+        bool snapshot(const std::string &path) const;
+};
+
+#endif // __FRAME_STATS_HPP_
\ No newline at end of file
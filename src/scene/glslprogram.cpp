@@ -1,5 +1,7 @@
 #include "glslprogram.hpp"
 
+#include "../profiler/profiler.hpp"
+
 #include <iostream>
 #include <fstream>
 
@@ -199,6 +201,49 @@ std::size_t GLSLProgram::getNumberOfShaders() const {
 }
 
 
+// Get the active status of the given uniform within the program
+bool GLSLProgram::isUniformActive(const GLchar *name) {
+    // Invalid programs have no active uniforms
+    if (program == GL_FALSE) {
+        return false;
+    }
+
+    // Check the stored location
+    std::map<std::string, GLint>::const_iterator result = location_stock.find(name);
+    if (result != location_stock.end()) {
+        return result->second != -1;
+    }
+
+    // Query the non stored uniform location and insert in the location stock
+    const GLint location = glGetUniformLocation(program, name);
+    location_stock[name] = location;
+
+    // Return true if the uniform is active
+    return location != -1;
+}
+
+// Get the active status of the given vertex attribute within the program
+bool GLSLProgram::isAttributeActive(const GLchar *name) {
+    // Invalid programs have no active attributes
+    if (program == GL_FALSE) {
+        return false;
+    }
+
+    // Check the stored location
+    std::map<std::string, GLint>::const_iterator result = attribute_stock.find(name);
+    if (result != attribute_stock.end()) {
+        return result->second != -1;
+    }
+
+    // Query the non stored attribute location and insert in the attribute stock
+    const GLint location = glGetAttribLocation(program, name);
+    attribute_stock[name] = location;
+
+    // Return true if the attribute is active
+    return location != -1;
+}
+
+
 // Setters
 
 // Set the value for an integer uniform
@@ -246,9 +291,12 @@ void GLSLProgram::setUniform(const GLchar *name, const glm::mat4 &matrix) {
 
 // Link a new pogram using the current shaders source paths
 void GLSLProgram::link() {
+    PROFILE_ZONE("GLSLProgram::link");
+
     // Delete previous program and reset ID
     if (program != GL_FALSE) {
         location_stock.clear();
+        attribute_stock.clear();
         glDeleteProgram(program);
         program = GL_FALSE;
     }
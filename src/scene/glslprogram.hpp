@@ -40,6 +40,9 @@ class GLSLProgram {
         /** Uniform location stock */
         std::map<std::string, GLint> location_stock;
 
+        /** Vertex attribute location stock */
+        std::map<std::string, GLint> attribute_stock;
+
         // Constructors
 
         /** Disable the default copy constructor */
@@ -99,6 +102,13 @@ class GLSLProgram {
         std::size_t getNumberOfShaders() const;
 
 
+        /** Get the active status of the given uniform within the program */
+        bool isUniformActive(const GLchar *name);
+
+        /** Get the active status of the given vertex attribute within the program */
+        bool isAttributeActive(const GLchar *name);
+
+
         // Setters
 
         /** Set the value for an integer uniform */
@@ -0,0 +1,142 @@
+#include "governor.hpp"
+
+#include <glm/common.hpp>
+
+#include <algorithm>
+
+
+// Static const attributes
+
+// Frame time ratio over the target that lowers the quality
+const double Governor::DEGRADE_RATIO = 1.05;
+
+// Frame time ratio under the target that raises the quality
+const double Governor::IMPROVE_RATIO = 0.75;
+
+// Quality step to lower
+const float Governor::DEGRADE_STEP = 0.1F;
+
+// Quality step to raise
+const float Governor::IMPROVE_STEP = 0.05F;
+
+// Frames to wait after an adjustment
+const int Governor::COOLDOWN_FRAMES = 30;
+
+
+// Constructor
+
+// Governor constructor
+Governor::Governor(const double &target) :
+    // Disabled by default
+    enabled(false),
+
+    // Frame rate and time
+    target(target),
+    frame_time(0.0),
+
+    // Full quality
+    quality(1.0F),
+    cooldown(0) {}
+
+
+// Getters
+
+// Get the enabled status
+bool Governor::isEnabled() const {
+    return enabled;
+}
+
+// Get the target frame rate
+double Governor::getTargetFrameRate() const {
+    return target;
+}
+
+// Get the smoothed frame time in milliseconds
+double Governor::getFrameTime() const {
+    return frame_time;
+}
+
+// Get the quality level
+float Governor::getQuality() const {
+    return quality;
+}
+
+
+// Get the render scale for the current quality
+float Governor::getRenderScale() const {
+    return glm::mix(0.5F, 1.0F, quality);
+}
+
+// Get the parallax mapping maximum layers for the current quality
+float Governor::getMaxLayers() const {
+    return glm::mix(8.0F, 32.0F, quality);
+}
+
+// Get the parallax mapping minimum layers for the current quality
+float Governor::getMinLayers() const {
+    return glm::mix(4.0F, 8.0F, quality);
+}
+
+// Get the texture level of detail bias for the current quality
+float Governor::getLODBias() const {
+    return glm::mix(1.5F, 0.0F, quality);
+}
+
+
+// Setters
+
+// Set the enabled status
+void Governor::setEnabled(const bool &status) {
+    enabled = status;
+    cooldown = Governor::COOLDOWN_FRAMES;
+}
+
+// Set the target frame rate
+void Governor::setTargetFrameRate(const double &fps) {
+    target = std::max(fps, 1.0);
+}
+
+// Set the quality level
+void Governor::setQuality(const float &value) {
+    quality = glm::clamp(value, 0.0F, 1.0F);
+}
+
+
+// Methods
+
+// Update with the CPU and GPU frame times in milliseconds, true if the quality changed
+bool Governor::update(const double &cpu_time, const double &gpu_time) {
+    // Smooth the frame time bound by the slowest processor
+    frame_time += (std::max(cpu_time, gpu_time) - frame_time) * 0.1;
+
+    // Nothing to adjust if disabled
+    if (!enabled) {
+        return false;
+    }
+
+    // Wait for the previous adjustment to take effect
+    if (cooldown > 0) {
+        cooldown--;
+        return false;
+    }
+
+    // Lower the quality quickly over the target and raise it slowly with enough headroom
+    const double target_time = 1000.0 / target;
+    float value = quality;
+    if (frame_time > target_time * Governor::DEGRADE_RATIO) {
+        value -= Governor::DEGRADE_STEP;
+    } else if (frame_time < target_time * Governor::IMPROVE_RATIO) {
+        value += Governor::IMPROVE_STEP;
+    }
+
+    // Clamp the quality and check the change
+    value = glm::clamp(value, 0.0F, 1.0F);
+    if (value == quality) {
+        return false;
+    }
+
+    // Apply the new quality and wait for it
+    quality = value;
+    cooldown = Governor::COOLDOWN_FRAMES;
+    return true;
+}
\ No newline at end of file
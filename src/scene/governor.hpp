@@ -0,0 +1,96 @@
+#ifndef __GOVERNOR_HPP_
+#define __GOVERNOR_HPP_
+
+
+class Governor {
+    private:
+        // Attributes
+
+        /** Enabled status */
+        bool enabled;
+
+        /** Target frame rate */
+        double target;
+
+        /** Smoothed frame time in milliseconds */
+        double frame_time;
+
+        /** Quality level between 0 and 1 */
+        float quality;
+
+        /** Frames to wait before the next adjustment */
+        int cooldown;
+
+
+        // Static const attributes
+
+        /** Frame time ratio over the target that lowers the quality */
+        static const double DEGRADE_RATIO;
+
+        /** Frame time ratio under the target that raises the quality */
+        static const double IMPROVE_RATIO;
+
+        /** Quality step to lower */
+        static const float DEGRADE_STEP;
+
+        /** Quality step to raise */
+        static const float IMPROVE_STEP;
+
+        /** Frames to wait after an adjustment */
+        static const int COOLDOWN_FRAMES;
+
+
+    public:
+        // Constructor
+
+        /** Governor constructor */
+        Governor(const double &target = 60.0);
+
+
+        // Getters
+
+        /** Get the enabled status */
+        bool isEnabled() const;
+
+        /** Get the target frame rate */
+        double getTargetFrameRate() const;
+
+        /** Get the smoothed frame time in milliseconds */
+        double getFrameTime() const;
+
+        /** Get the quality level */
+        float getQuality() const;
+
+
+        /** Get the render scale for the current quality */
+        float getRenderScale() const;
+
+        /** Get the parallax mapping maximum layers for the current quality */
+        float getMaxLayers() const;
+
+        /** Get the parallax mapping minimum layers for the current quality */
+        float getMinLayers() const;
+
+        /** Get the texture level of detail bias for the current quality */
+        float getLODBias() const;
+
+
+        // Setters
+
+        /** Set the enabled status */
+        void setEnabled(const bool &status);
+
+        /** Set the target frame rate */
+        void setTargetFrameRate(const double &fps);
+
+        /** Set the quality level */
+        void setQuality(const float &value);
+
+
+        // Methods
+
+        /** Update with the CPU and GPU frame times in milliseconds, true if the quality changed */
+        bool update(const double &cpu_time, const double &gpu_time);
+};
+
+#endif // __GOVERNOR_HPP_
\ No newline at end of file
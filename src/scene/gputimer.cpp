@@ -0,0 +1,102 @@
+#include "gputimer.hpp"
+
+
+// Constructor
+
+// GPU timer constructor
+GPUTimer::GPUTimer() :
+    // Default statuses
+    pending{false, false},
+    current(0),
+    elapsed(0.0),
+
+    // Empty rolling window
+    samples(0),
+    next(0) {
+    // Generate the queries
+    glGenQueries(2, query);
+}
+
+
+// Private methods
+
+// Store an elapsed time in milliseconds
+void GPUTimer::store(const double &time) {
+    // Update the last elapsed time and the rolling window
+    elapsed = time;
+    sample[next] = time;
+    next = (next + 1) % GPUTimer::SAMPLES;
+    if (samples < GPUTimer::SAMPLES) {
+        samples++;
+    }
+}
+
+
+// Getters
+
+// Get the last available elapsed time in milliseconds
+double GPUTimer::getElapsed() const {
+    return elapsed;
+}
+
+// Get the rolling average elapsed time in milliseconds
+double GPUTimer::getAverage() const {
+    double sum = 0.0;
+    for (int i = 0; i < samples; i++) {
+        sum += sample[i];
+    }
+    return samples == 0 ? 0.0 : sum / samples;
+}
+
+// Get the rolling maximum elapsed time in milliseconds
+double GPUTimer::getMaximum() const {
+    double maximum = 0.0;
+    for (int i = 0; i < samples; i++) {
+        maximum = sample[i] > maximum ? sample[i] : maximum;
+    }
+    return maximum;
+}
+
+
+// Methods
+
+// Begin the time elapsed query and collect the result of the previous one without stalling
+void GPUTimer::begin() {
+    // Collect the result issued two frames ago if it is available
+    if (pending[current]) {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(query[current], GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if (available != GL_FALSE) {
+            GLuint64 nanoseconds = 0U;
+            glGetQueryObjectui64v(query[current], GL_QUERY_RESULT, &nanoseconds);
+            store(static_cast<double>(nanoseconds) * 1.0E-6);
+        }
+
+        pending[current] = false;
+    }
+
+    // Begin the query
+    glBeginQuery(GL_TIME_ELAPSED, query[current]);
+}
+
+// End the time elapsed query
+void GPUTimer::end() {
+    // End the query and swap to the next one
+    glEndQuery(GL_TIME_ELAPSED);
+    pending[current] = true;
+    current ^= 1;
+}
+
+// Record an empty elapsed time for a skipped pass
+void GPUTimer::skip() {
+    store(0.0);
+}
+
+
+// Destructor
+
+// GPU timer destructor
+GPUTimer::~GPUTimer() {
+    glDeleteQueries(2, query);
+}
\ No newline at end of file
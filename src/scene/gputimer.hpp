@@ -0,0 +1,92 @@
+#ifndef __GPU_TIMER_HPP_
+#define __GPU_TIMER_HPP_
+
+#include "../glad/glad.h"
+
+
+class GPUTimer {
+    private:
+        // Static const attributes
+
+        /** Number of samples of the rolling window */
+        static const int SAMPLES = 60;
+
+
+        // Attributes
+
+        /** Double buffered time elapsed queries */
+        GLuint query[2];
+
+        /** Pending result status of each query */
+        bool pending[2];
+
+        /** Current query index */
+        int current;
+
+        /** Last elapsed time in milliseconds */
+        double elapsed;
+
+
+        /** Rolling window of elapsed times */
+        double sample[GPUTimer::SAMPLES];
+
+        /** Number of stored samples */
+        int samples;
+
+        /** Next sample index */
+        int next;
+
+
+        // Constructors
+
+        /** Disable the default copy constructor */
+        GPUTimer(const GPUTimer &) = delete;
+
+        /** Disable the assignation operator */
+        GPUTimer &operator=(const GPUTimer &) = delete;
+
+
+        // Methods
+
+        /** Store an elapsed time in milliseconds */
+        void store(const double &time);
+
+
+    public:
+        // Constructor
+
+        /** GPU timer constructor */
+        GPUTimer();
+
+
+        // Getters
+
+        /** Get the last available elapsed time in milliseconds */
+        double getElapsed() const;
+
+        /** Get the rolling average elapsed time in milliseconds */
+        double getAverage() const;
+
+        /** Get the rolling maximum elapsed time in milliseconds */
+        double getMaximum() const;
+
+
+        // Methods
+
+        /** Begin the time elapsed query and collect the result of the previous one without stalling */
+        void begin();
+
+        /** End the time elapsed query */
+        void end();
+
+        /** Record an empty elapsed time for a skipped pass */
+        void skip();
+
+
+        // Destructor
+
+        /** GPU timer destructor */
+        virtual ~GPUTimer();
+};
+
+#endif // __GPU_TIMER_HPP_
\ No newline at end of file
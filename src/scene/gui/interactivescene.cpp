@@ -2,6 +2,8 @@
 
 #include "customwidgets.hpp"
 
+#include "../../profiler/profiler.hpp"
+
 #include "imgui/imgui.h"
 #include "imgui/imgui_impl_glfw.h"
 #include "imgui/imgui_impl_opengl3.h"
@@ -26,6 +28,9 @@ const std::map<Material::Attribute, std::string> InteractiveScene::AVAILABLE_TEX
 //Types of lights labels
 const char *InteractiveScene::LIGHT_TYPE_LABEL[] = {"Directional", "Point", "Spotlight"};
 
+// GUI frames to draw after an input event to let the GUI settle
+const int InteractiveScene::SETTLE_FRAMES = 3;
+
 
 // Private static attributes
 
@@ -35,33 +40,50 @@ char InteractiveScene::repository_url[] = "https://github.com/Rebaya17/objviewer
 
 // Private statics methods
 
+// Draw a GPU timer row
+void InteractiveScene::timerWidget(const char *const label, const GPUTimer *const timer) {
+    ImGui::Text("%s", label);
+    ImGui::SameLine(150.0F);
+    ImGui::Text("%.3f", timer->getAverage());
+    ImGui::SameLine(250.0F);
+    ImGui::Text("%.3f", timer->getMaximum());
+}
+
+
 // GLFW framebuffer size callback
 void InteractiveScene::framebufferSizeCallback(GLFWwindow *window, int width, int height) {
     // Execute the scene framebuffer size callback
     Scene::framebufferSizeCallback(window, width, height);
 
-    // Resize the mouse resolution
-    static_cast<InteractiveScene *>(glfwGetWindowUserPointer(window))->mouse->setResolution(width, height);
+    // Resize the mouse resolution and draw the GUI
+    InteractiveScene *const scene = static_cast<InteractiveScene *>(glfwGetWindowUserPointer(window));
+    scene->mouse->setResolution(width, height);
+    scene->gui_frames = InteractiveScene::SETTLE_FRAMES;
 }
 
 // GLFW mouse button callback
 void InteractiveScene::mouseButtonCallback(GLFWwindow *window, int, int action, int) {
+    // Get the interactive scene and draw the GUI
+    InteractiveScene *const scene = static_cast<InteractiveScene *>(glfwGetWindowUserPointer(window));
+    scene->gui_frames = InteractiveScene::SETTLE_FRAMES;
+
     // Get the ImGuiIO reference and the capture IO status
     ImGuiIO &io = ImGui::GetIO();
     const bool capture_io = io.WantCaptureMouse || io.WantCaptureKeyboard || io.WantTextInput;
 
     // Disable the mouse if release a mouse button and the GUI don't want to capture IO
     if (!capture_io && (action == GLFW_RELEASE)) {
-        static_cast<InteractiveScene *>(glfwGetWindowUserPointer(window))->setCursorEnabled(false);
+        scene->setCursorEnabled(false);
     }
 }
 
 // GLFW cursor callback
 void InteractiveScene::cursorPosCallback(GLFWwindow *window, double xpos, double ypos) {
-    // Get the interactive scene
+    // Get the interactive scene and draw the GUI
     InteractiveScene *const scene = static_cast<InteractiveScene *>(glfwGetWindowUserPointer(window));
     scene->cursor_position.x = static_cast<float>(xpos);
     scene->cursor_position.y = static_cast<float>(ypos);
+    scene->gui_frames = InteractiveScene::SETTLE_FRAMES;
 
     // Get the ImGuiIO reference and the capture IO status
     ImGuiIO &io = ImGui::GetIO();
@@ -74,7 +96,7 @@ void InteractiveScene::cursorPosCallback(GLFWwindow *window, double xpos, double
 
         // Update the grabbed lights direction
         const glm::vec3 direction = scene->active_camera->getDirection();
-        for (std::pair<const std::size_t, Light *> &light_data : scene->light_stock) {
+        for (std::pair<std::size_t, Light *> &light_data : scene->light_stock) {
             if (light_data.second->isGrabbed()) {
                 light_data.second->setDirection(direction);
             }
@@ -84,13 +106,17 @@ void InteractiveScene::cursorPosCallback(GLFWwindow *window, double xpos, double
 
 // GLFW scroll callback
 void InteractiveScene::scrollCallback(GLFWwindow *window, double, double yoffset) {
+    // Get the interactive scene and draw the GUI
+    InteractiveScene *const scene = static_cast<InteractiveScene *>(glfwGetWindowUserPointer(window));
+    scene->gui_frames = InteractiveScene::SETTLE_FRAMES;
+
     // Get the ImGuiIO reference and the capture IO status
     ImGuiIO &io = ImGui::GetIO();
     const bool capture_io = io.WantCaptureMouse || io.WantCaptureKeyboard || io.WantTextInput;
 
     // Update the active camera zoom if the GUI don't want to capture IO
     if (!capture_io) {
-        static_cast<InteractiveScene *>(glfwGetWindowUserPointer(window))->active_camera->zoom(yoffset);
+        scene->active_camera->zoom(yoffset);
     }
 }
 
@@ -99,8 +125,9 @@ void InteractiveScene::keyCallback(GLFWwindow *window, int key, int, int action,
     // Get the pressed status
     bool pressed = action != GLFW_RELEASE;
 
-    // Get the interactive scene
+    // Get the interactive scene and draw the GUI
     InteractiveScene *const scene = static_cast<InteractiveScene *>(glfwGetWindowUserPointer(window));
+    scene->gui_frames = InteractiveScene::SETTLE_FRAMES;
 
     // Get the ImGuiIO reference and the capture IO status
     ImGuiIO &io = ImGui::GetIO();
@@ -122,6 +149,13 @@ void InteractiveScene::keyCallback(GLFWwindow *window, int key, int, int action,
             }
             return;
 
+        // Dump the profiler trace of the last frames
+        case GLFW_KEY_F9:
+            if (pressed) {
+                Profiler::dump("objviewer_trace.json", 120U);
+            }
+            return;
+
         // Toggle the about ImGui window
         case GLFW_KEY_F11:
             if (pressed) {
@@ -151,16 +185,28 @@ void InteractiveScene::keyCallback(GLFWwindow *window, int key, int, int action,
     }
 }
 
+// GLFW char callback
+void InteractiveScene::charCallback(GLFWwindow *window, unsigned int) {
+    // Draw the GUI for the text input
+    static_cast<InteractiveScene *>(glfwGetWindowUserPointer(window))->gui_frames = InteractiveScene::SETTLE_FRAMES;
+}
+
 
 // Private methods
 
 // Draw the GUI
 void InteractiveScene::drawGUI() {
+    PROFILE_ZONE("InteractiveScene::drawGUI");
+
     // Check the visibility of all windows
     if (!show_main_gui && !show_metrics && !show_about && !show_about_imgui) {
+        gui_timer->skip();
         return;
     }
 
+    // Measure the GUI GPU time
+    gui_timer->begin();
+
     // New ImGui frame
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
@@ -204,9 +250,15 @@ void InteractiveScene::drawGUI() {
         case InteractiveScene::NONE: break;
     }
 
+    // Redraw the scene while dragging a widget or after a click or an enter that may have edited it
+    if ((ImGui::IsAnyItemActive() && ImGui::IsMouseDown(0)) || ImGui::IsMouseReleased(0) || ImGui::IsKeyReleased(ImGui::GetKeyIndex(ImGuiKey_Enter))) {
+        redraw = true;
+    }
+
     // Render the GUI
     ImGui::Render();
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    gui_timer->end();
 }
 
 
@@ -233,6 +285,7 @@ void InteractiveScene::showMainGUIWindow() {
         ImGui::BulletText("ESCAPE to toggle the navigation mode.");
         ImGui::BulletText("Click in the scene to enter in the navigation mode.");
         ImGui::BulletText("F1 to toggle the about window.");
+        ImGui::BulletText("F9 to dump the profiler trace of the last 120 frames.");
         ImGui::BulletText("F12 to toggle the Dear ImGui metrics window.");
         ImGui::BulletText("Double-click on title bar to collapse window.");
 
@@ -291,6 +344,163 @@ void InteractiveScene::showMainGUIWindow() {
             ImGui::Text("Mouse: %.0f, %.0f", cursor_position.x, cursor_position.y);
             ImGui::HelpMarker("[x, y]");
             ImGui::ColorEdit3("Background", &background_color.r);
+
+            // Geometry buffer layout
+            const bool compact = Scene::geometry_buffer_layout == Scene::COMPACT;
+            if (ImGui::RadioButton("Standard", !compact)) {
+                Scene::setGeometryBufferLayout(Scene::STANDARD);
+            }
+            ImGui::SameLine();
+            if (ImGui::RadioButton("Compact", compact)) {
+                Scene::setGeometryBufferLayout(Scene::COMPACT);
+            }
+            ImGui::SameLine(338.0F);
+            ImGui::Text("G-buffer");
+            ImGui::HelpMarker("Compact reconstructs the position from depth,\nstores octahedral normals in RG16 and 8-bit metadata");
+
+            // Render scale
+            float scale = Scene::render_scale;
+            if (ImGui::SliderFloat("Render scale", &scale, 0.25F, 2.0F, "%.2f")) {
+                Scene::setRenderScale(scale);
+            }
+            ImGui::HelpMarker("Internal resolution relative to the window.\nLower it for big scenes.");
+            ImGui::Text("Buffers: %dx%d", Scene::buffer_width, Scene::buffer_height);
+            ImGui::TreePop();
+        }
+
+        // Frame time governor
+        if (ImGui::TreeNodeEx("Performance", ImGuiTreeNodeFlags_DefaultOpen)) {
+            // Vertical synchronization
+            bool value = vsync;
+            if (ImGui::Checkbox("VSync", &value)) {
+                setVSyncEnabled(value);
+            }
+
+            // Governor status
+            ImGui::SameLine(210.0F);
+            value = governor.isEnabled();
+            if (ImGui::Checkbox("Governor", &value)) {
+                governor.setEnabled(value);
+                Scene::setRenderScale(governor.getRenderScale());
+            }
+            ImGui::HelpMarker("Adjust the render scale, parallax layers and\ntexture LOD bias to hold the target frame rate.");
+
+            // Depth pre-pass
+            value = depth_prepass;
+            if (ImGui::Checkbox("Depth pre-pass", &value)) {
+                setDepthPrepassEnabled(value);
+            }
+            ImGui::SameLine(210.0F);
+            ImGui::Text("Overdraw saved: %.0f%%", getOverdrawSaved() * 100.0F);
+            ImGui::HelpMarker("Write the depth of the opaque objects first so the\ngeometry pass shades each visible pixel once.");
+
+            // Culling mode
+            if (ImGui::RadioButton("Frustum", culling == Scene::FRUSTUM_CULLING)) {
+                setCulling(Scene::FRUSTUM_CULLING);
+            }
+            ImGui::SameLine();
+            if (ImGui::RadioButton("Software", culling == Scene::SOFTWARE_OCCLUSION)) {
+                setCulling(Scene::SOFTWARE_OCCLUSION);
+            }
+            ImGui::SameLine();
+            if (ImGui::RadioButton("Queries", culling == Scene::HARDWARE_OCCLUSION)) {
+                setCulling(Scene::HARDWARE_OCCLUSION);
+            }
+            ImGui::SameLine(338.0F);
+            ImGui::Text("Culling");
+            ImGui::HelpMarker("Software skips the models hidden behind the largest\nones in a small depth buffer. Queries test the\nbounding boxes on the GPU reusing the previous frame\nvisibility, without needing CPU occluders.");
+
+            // Target frame rate
+            float target = static_cast<float>(governor.getTargetFrameRate());
+            if (ImGui::DragFloat("Target FPS", &target, 1.0F, 1.0F, 240.0F, "%.0f")) {
+                governor.setTargetFrameRate(target);
+            }
+
+            // Quality, manual only if the governor is disabled
+            float quality = governor.getQuality();
+            if (ImGui::SliderFloat("Quality", &quality, 0.0F, 1.0F, "%.2f") && !governor.isEnabled()) {
+                governor.setQuality(quality);
+            }
+
+            // Governor output
+            ImGui::Text("Frame: %.2fms", governor.getFrameTime());
+            ImGui::SameLine(210.0F);
+            ImGui::Text("GPU: %.2fms", getGPUFrameTime());
+            ImGui::Text("Layers: %.0f-%.0f", governor.getMinLayers(), governor.getMaxLayers());
+            ImGui::SameLine(210.0F);
+            ImGui::Text("LOD bias: %.2f", governor.getLODBias());
+            ImGui::Text("Draw calls: %u", static_cast<unsigned int>(draw_calls));
+            ImGui::Text("Occluded: %u models, %u objects (%.0f%%)", static_cast<unsigned int>(occluded_models), static_cast<unsigned int>(occluded_objects), occluded_fraction * 100.0F);
+            ImGui::TreePop();
+        }
+
+        // GPU time of each pass
+        if (ImGui::TreeNode("GPU timing")) {
+            ImGui::TextDisabled("Pass");
+            ImGui::SameLine(150.0F);
+            ImGui::TextDisabled("Average");
+            ImGui::SameLine(250.0F);
+            ImGui::TextDisabled("Maximum");
+            ImGui::HelpMarker("Rolling window of the last 60 results in milliseconds");
+
+            // Scene passes
+            InteractiveScene::timerWidget("Geometry", geometry_timer);
+            InteractiveScene::timerWidget("Background", background_timer);
+            for (const std::pair<const std::size_t, GPUTimer *> &timer_data : light_timer) {
+                const std::string label = "Light " + std::to_string(timer_data.first);
+                InteractiveScene::timerWidget(label.c_str(), timer_data.second);
+            }
+            InteractiveScene::timerWidget("Composite", composite_timer);
+            InteractiveScene::timerWidget("GUI", gui_timer);
+
+            // Frame total
+            ImGui::Separator();
+            ImGui::Text("Total: %.3fms", getGPUFrameTime());
+            ImGui::TreePop();
+        }
+
+        // Frame times statistics
+        if (ImGui::TreeNode("Frame times")) {
+            // Percentiles
+            const FrameStats::Percentiles cpu = frame_stats.getCPUPercentiles();
+            const FrameStats::Percentiles gpu = frame_stats.getGPUPercentiles();
+            const float scale = cpu.max > gpu.max ? cpu.max : gpu.max;
+
+            // CPU and GPU graphs
+            ImGui::PlotLines("CPU", frame_stats.getCPUTimes(), frame_stats.getFrames(), frame_stats.getOffset(), nullptr, 0.0F, scale, ImVec2(0.0F, 60.0F));
+            ImGui::PlotLines("GPU", frame_stats.getGPUTimes(), frame_stats.getFrames(), frame_stats.getOffset(), nullptr, 0.0F, scale, ImVec2(0.0F, 60.0F));
+
+            // Percentiles table
+            ImGui::TextDisabled("ms");
+            ImGui::SameLine(60.0F);  ImGui::TextDisabled("p50");
+            ImGui::SameLine(120.0F); ImGui::TextDisabled("p95");
+            ImGui::SameLine(180.0F); ImGui::TextDisabled("p99");
+            ImGui::SameLine(240.0F); ImGui::TextDisabled("max");
+            ImGui::HelpMarker("Percentiles of the last 1024 frames");
+            ImGui::Text("CPU");
+            ImGui::SameLine(60.0F);  ImGui::Text("%.2f", cpu.p50);
+            ImGui::SameLine(120.0F); ImGui::Text("%.2f", cpu.p95);
+            ImGui::SameLine(180.0F); ImGui::Text("%.2f", cpu.p99);
+            ImGui::SameLine(240.0F); ImGui::Text("%.2f", cpu.max);
+            ImGui::Text("GPU");
+            ImGui::SameLine(60.0F);  ImGui::Text("%.2f", gpu.p50);
+            ImGui::SameLine(120.0F); ImGui::Text("%.2f", gpu.p95);
+            ImGui::SameLine(180.0F); ImGui::Text("%.2f", gpu.p99);
+            ImGui::SameLine(240.0F); ImGui::Text("%.2f", gpu.max);
+
+            // Hitches
+            ImGui::Text("Hitches: %lu", frame_stats.getHitches());
+            ImGui::HelpMarker("Frames over twice the median frame time");
+
+            // Reset and snapshot actions
+            if (ImGui::Button("Reset")) {
+                frame_stats.reset();
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Snapshot")) {
+                frame_stats.snapshot("objviewer_frames.csv");
+            }
+            ImGui::HelpMarker("Write the frame times to objviewer_frames.csv");
             ImGui::TreePop();
         }
 
@@ -304,7 +514,7 @@ void InteractiveScene::showMainGUIWindow() {
             std::size_t textures  = 0U;
 
             // Calculate models statistics
-            for (const std::pair<const std::size_t, const std::pair<const Model *const, const std::size_t> > &program_data : model_stock) {
+            for (const std::pair<std::size_t, std::pair<Model *, std::size_t> > &program_data : model_stock) {
                 vertices  += program_data.second.first->getNumberOfVertices();
                 elements  += program_data.second.first->getNumberOfElements();
                 triangles += program_data.second.first->getNumberOfTriangles();
@@ -314,7 +524,7 @@ void InteractiveScene::showMainGUIWindow() {
 
             // // Calculate program statistics
             std::size_t shaders = 0U;
-            for (const std::pair<const std::size_t, std::pair<const GLSLProgram *const, const std::string> > &program_data : program_stock) {
+            for (const std::pair<std::size_t, std::pair<GLSLProgram *, std::string> > &program_data : program_stock) {
                 shaders += program_data.second.first->getNumberOfShaders();
             }
 
@@ -381,13 +591,13 @@ void InteractiveScene::showMainGUIWindow() {
         std::size_t remove = 0U;
 
         // Draw each camera node
-        for (const std::pair<const std::size_t, Camera *const> &camera_data : camera_stock) {
-            // ID and title strings
+        for (const std::pair<std::size_t, Camera *> &camera_data : camera_stock) {
+            // ID and title strings, the node IDs are prefixed as each stock numbers its own
             const std::string id = std::to_string(camera_data.first);
             const std::string camera_title = "Camera " + id;
 
             // Draw node and catch the selected to remove
-            if (ImGui::TreeNode(id.c_str(), camera_title.c_str())) {
+            if (ImGui::TreeNode(("camera" + id).c_str(), camera_title.c_str())) {
                 if (!cameraWidget(camera_data.second, camera_data.first)) {
                     remove = camera_data.first;
                 }
@@ -414,13 +624,13 @@ void InteractiveScene::showMainGUIWindow() {
         std::size_t remove = 0U;
 
         // Draw each model node
-        for (std::pair<const std::size_t, std::pair<Model *, std::size_t> > &program_data : model_stock) {
+        for (std::pair<std::size_t, std::pair<Model *, std::size_t> > &program_data : model_stock) {
             // ID and title strings
             const std::string id = std::to_string(program_data.first);
             const std::string program_title = "Model " + id + ": " + program_data.second.first->getName();
 
             // Draw node and catch the selected to remove
-            if (ImGui::TreeNode(id.c_str(), program_title.c_str())) {
+            if (ImGui::TreeNode(("model" + id).c_str(), program_title.c_str())) {
                 if (!modelWidget(program_data.second)) {
                     remove = program_data.first;
                 }
@@ -443,17 +653,28 @@ void InteractiveScene::showMainGUIWindow() {
 
     // Lights section
     if (ImGui::CollapsingHeader("Lights")) {
+        // Global settings
+        if (ImGui::TreeNodeEx("Global", ImGuiTreeNodeFlags_DefaultOpen)) {
+            // Attenuation threshold
+            float value = Light::getAttenuationThreshold();
+            if (ImGui::DragFloat("Threshold", &value, 0.0001F, 0.0001F, 1.0F, "%.4f")) {
+                Light::setAttenuationThreshold(value);
+            }
+            ImGui::HelpMarker("Attenuation below which point and\nspotlight lights are ignored.");
+            ImGui::TreePop();
+        }
+
         // Program to remove ID
         std::size_t remove = 0U;
 
         // Draw each light node
-        for (const std::pair<const std::size_t, Light *const> &light_data : light_stock) {
+        for (const std::pair<std::size_t, Light *> &light_data : light_stock) {
             // ID and title strings
             const std::string id = std::to_string(light_data.first);
             const std::string light_title = "Light " + id;
 
             // Draw node and catch the selected to remove
-            if (ImGui::TreeNode(id.c_str(), light_title.c_str())) {
+            if (ImGui::TreeNode(("light" + id).c_str(), light_title.c_str())) {
                 if (!lightWidget(light_data.second)) {
                     remove = light_data.first;
                 }
@@ -483,7 +704,7 @@ void InteractiveScene::showMainGUIWindow() {
         ImGui::BulletText("Lighting pass program");
         ImGui::Indent();
         // Program title with ID
-        std::map<std::size_t, std::pair<GLSLProgram *, std::string> >::const_iterator result = program_stock.find(lighting_program);
+        SlotMap<std::pair<GLSLProgram *, std::string> >::const_iterator result = program_stock.find(lighting_program);
         std::string program_title = (result == program_stock.end() ? "NULL" : result->second.second);
         if ((lighting_program != 0U) && (lighting_program != 1U)) {
             program_title.append(" (").append(std::to_string(lighting_program)).append(")");
@@ -493,7 +714,7 @@ void InteractiveScene::showMainGUIWindow() {
         if (ImGui::BeginCombo("###lighting_pass_program", program_title.c_str())) {
             // For each program in the stock show the item and make the selection
             size_t new_program = lighting_program;
-            for (const std::pair<const std::size_t, std::pair<const GLSLProgram *const, const std::string> > &program_data : program_stock) {
+            for (const std::pair<std::size_t, std::pair<GLSLProgram *, std::string> > &program_data : program_stock) {
                 if (programComboItem(lighting_program, program_data.first)) {
                     new_program = program_data.first;
                 }
@@ -505,7 +726,7 @@ void InteractiveScene::showMainGUIWindow() {
         ImGui::Unindent();
 
         // Draw each program node
-        for (std::pair<const std::size_t, std::pair<GLSLProgram *, std::string> > &program_data : program_stock) {
+        for (std::pair<std::size_t, std::pair<GLSLProgram *, std::string> > &program_data : program_stock) {
             // ID string
             const std::string id = std::to_string(program_data.first);
 
@@ -527,7 +748,7 @@ void InteractiveScene::showMainGUIWindow() {
             }
 
             // Draw node and catch the selected to remove
-            if (ImGui::TreeNode(id.c_str(), program_title.c_str())) {
+            if (ImGui::TreeNode(("program" + id).c_str(), program_title.c_str())) {
                 if (!programWidget(program_data.second)) {
                     remove = program_data.first;
                 }
@@ -659,11 +880,13 @@ bool InteractiveScene::modelWidget(std::pair<Model *, std::size_t> &model_data)
         ImGui::SameLine(210.0F);
         ImGui::Text("Textures:  %lu", model->getNumberOfTextures());
         ImGui::Text("Triangles: %lu", model->getNumberOfTriangles());
+        ImGui::SameLine(210.0F);
+        ImGui::Text("Load memory: %ld KB", model->getLoadMemory()); ImGui::HelpMarker("Largest resident set size growth of the process\nsampled during the load, concurrent loads included");
         ImGui::TreePop();
     }
 
     // Program title with the ID for non default programs
-    std::map<std::size_t, std::pair<GLSLProgram *, std::string> >::const_iterator result = program_stock.find(program);
+    SlotMap<std::pair<GLSLProgram *, std::string> >::const_iterator result = program_stock.find(program);
     std::string program_title = (result == program_stock.end() ? "NULL" : result->second.second);
     if ((program != 0U) && (program != 1U)) {
         program_title.append(" (").append(std::to_string(program)).append(")");
@@ -673,7 +896,7 @@ bool InteractiveScene::modelWidget(std::pair<Model *, std::size_t> &model_data)
     if (ImGui::BeginCombo("GLSL program", program_title.c_str())) {
         // For each program in the stock show the item and make the selection
         size_t new_program = model_data.second;
-        for (const std::pair<const std::size_t, std::pair<const GLSLProgram *const, const std::string> > &program_data : program_stock) {
+        for (const std::pair<std::size_t, std::pair<GLSLProgram *, std::string> > &program_data : program_stock) {
             if (programComboItem(model_data.second, program_data.first)) {
                 new_program = program_data.first;
             }
@@ -1078,6 +1301,8 @@ bool InteractiveScene::lightWidget(Light *const light) {
             light->setAttenuation(vector);
         }
         ImGui::HelpMarker("[Constant, Linear, Quadratic]\nIf any value is negative rare\neffects may appear.");
+        ImGui::Text("Radius: %.4f", light->getRadius());
+        ImGui::HelpMarker("Effective radius for the\nglobal attenuation threshold");
 
         // Cutoff for spotlight lights
         if (type == Light::SPOTLIGHT) {
@@ -1256,7 +1481,7 @@ void InteractiveScene::processKeyboardInput() {
 
     // Update the grabbed lights positions
     const glm::vec3 position = active_camera->getPosition();
-    for (std::pair<const std::size_t, Light *> &light_data : light_stock) {
+    for (std::pair<std::size_t, Light *> &light_data : light_stock) {
         if (light_data.second->isGrabbed()) {
             light_data.second->setPosition(position);
         }
@@ -1265,6 +1490,12 @@ void InteractiveScene::processKeyboardInput() {
 
 
 
+// Get the last frame GPU time in milliseconds including the GUI
+double InteractiveScene::getGPUFrameTime() const {
+    return Scene::getGPUFrameTime() + gui_timer->getElapsed();
+}
+
+
 // Constructor
 
 // Interactive scene constructor
@@ -1289,7 +1520,13 @@ InteractiveScene::InteractiveScene(const std::string &title, const int &width, c
     show_about_imgui(false),
 
     // Focus on GUI by default
-    focus_gui(true) {
+    focus_gui(true),
+
+    // GUI GPU timer
+    gui_timer(nullptr),
+
+    // Draw the first GUI frames
+    gui_frames(InteractiveScene::SETTLE_FRAMES) {
     // Load the GUI if is the first instance
     if ((Scene::instances == 1U) && Scene::initialized_glad) {
         // Set the user pointer to this scene and setup callbacks
@@ -1299,6 +1536,7 @@ InteractiveScene::InteractiveScene(const std::string &title, const int &width, c
         glfwSetCursorPosCallback(window, InteractiveScene::cursorPosCallback);
         glfwSetScrollCallback(window, InteractiveScene::scrollCallback);
         glfwSetKeyCallback(window, InteractiveScene::keyCallback);
+        glfwSetCharCallback(window, InteractiveScene::charCallback);
 
 
         // Setup the ImGui context
@@ -1320,6 +1558,11 @@ InteractiveScene::InteractiveScene(const std::string &title, const int &width, c
         ImGui::PushStyleVar(ImGuiStyleVar_GrabRounding, 2.0F);
     }
 
+    // Create the GUI GPU timer
+    if (Scene::initialized_glad) {
+        gui_timer = new GPUTimer();
+    }
+
     // Render the GUI before anything
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
@@ -1450,22 +1693,51 @@ void InteractiveScene::mainLoop() {
 
     // The rendering main loop
     while (glfwWindowShouldClose(window) == GLFW_FALSE) {
-        // Clear color and depth buffers
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        // Draw the scene and GUI
-        drawScene();
-        drawGUI();
-
         // Process the keyboard input
         processKeyboardInput();
 
-        // Poll events and swap buffers
-        glfwPollEvents();
-        glfwSwapBuffers(window);
+        // Draw only if the scene or the GUI have changed
+        const bool scene_changed = updateStateSignature();
+        if (scene_changed || (gui_frames > 0)) {
+            // Mark the frame for the profiler
+            Profiler::markFrame();
+
+            // Clear color and depth buffers
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            // Draw the scene or reuse the last lighting image if only the GUI has changed
+            const double frame_start = glfwGetTime();
+            if (scene_changed) {
+                drawScene();
+            }
+            else {
+                compositeScene();
+            }
+            drawGUI();
 
-        // Count frame
-        kframes += 0.001;
+            // Only the scene frames are timed, the GUI frames would mislead the governor
+            if (scene_changed) {
+                updateFrameTiming(glfwGetTime() - frame_start);
+            }
+
+            // Swap buffers
+            glfwSwapBuffers(window);
+
+            // Count frame
+            kframes += 0.001;
+        }
+
+        // Keep polling events while the scene or the GUI are changing, otherwise block until an event arrives
+        if (gui_frames > 0) {
+            gui_frames--;
+        }
+
+        if (scene_changed || redraw || (gui_frames > 0)) {
+            glfwPollEvents();
+        }
+        else {
+            glfwWaitEventsTimeout(Scene::IDLE_TIMEOUT);
+        }
     }
 }
 
@@ -1474,8 +1746,9 @@ void InteractiveScene::mainLoop() {
 
 // Interactive scene destructor
 InteractiveScene::~InteractiveScene() {
-    // Delete the mouse
+    // Delete the mouse and the GUI GPU timer
     delete mouse;
+    delete gui_timer;
 
     // Terminate GUI if is the last instance
     if ((Scene::instances == 1U) && Scene::initialized_glad) {
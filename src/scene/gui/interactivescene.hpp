@@ -55,6 +55,13 @@ class InteractiveScene : public Scene {
         bool focus_gui;
 
 
+        /** GUI GPU timer */
+        GPUTimer *gui_timer;
+
+        /** Remaining GUI frames to draw before waiting for events */
+        int gui_frames;
+
+
         // Methods
 
         /** Draw the GUI */
@@ -85,6 +92,10 @@ class InteractiveScene : public Scene {
         void processKeyboardInput();
 
 
+        /** Get the last frame GPU time in milliseconds including the GUI */
+        double getGPUFrameTime() const;
+
+
         // Static const attributes
 
         /** Available texures */
@@ -93,6 +104,9 @@ class InteractiveScene : public Scene {
         /** Types of lights labels */
         static const char *LIGHT_TYPE_LABEL[];
 
+        /** GUI frames to draw after an input event to let the GUI settle */
+        static const int SETTLE_FRAMES;
+
 
         // Static attributes
 
@@ -102,6 +116,10 @@ class InteractiveScene : public Scene {
 
         // Static methods
 
+        /** Draw a GPU timer row */
+        static void timerWidget(const char *const label, const GPUTimer *const timer);
+
+
         /** GLFW framebuffer size callback */
         static void framebufferSizeCallback(GLFWwindow *window, int width, int height);
 
@@ -117,6 +135,9 @@ class InteractiveScene : public Scene {
         /** GLFW key callback */
         static void keyCallback(GLFWwindow *window, int key, int, int action, int modifier);
 
+        /** GLFW char callback */
+        static void charCallback(GLFWwindow *window, unsigned int);
+
 
     public:
         // Constructor
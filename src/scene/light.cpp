@@ -2,6 +2,14 @@
 
 #include <glm/trigonometric.hpp>
 
+#include <cmath>
+
+
+// Static attributes
+
+// Attenuation threshold
+float Light::attenuation_threshold = 1.0F / 256.0F;
+
 
 // Constructors
 
@@ -111,6 +119,42 @@ float Light::getShininess() const {
 }
 
 
+// Get the effective radius
+float Light::getRadius() const {
+    // Directional lights reach everything
+    if (type == Light::DIRECTIONAL) {
+        return INFINITY;
+    }
+
+    // Brightest channel of the light
+    const glm::vec3 color = ambient_level * ambient_color + diffuse_level * diffuse_color + specular_level * specular_color;
+    const float brightness = glm::max(glm::max(color.r, color.g), color.b);
+
+    // Solve constant + linear * d + quadratic * d^2 = brightness / threshold
+    const float target = attenuation.x - brightness / Light::attenuation_threshold;
+
+    // Quadratic attenuation
+    if (attenuation.z > 0.0F) {
+        const float discriminant = attenuation.y * attenuation.y - 4.0F * attenuation.z * target;
+        return discriminant < 0.0F ? 0.0F : (std::sqrt(discriminant) - attenuation.y) / (2.0F * attenuation.z);
+    }
+
+    // Linear attenuation
+    if (attenuation.y > 0.0F) {
+        return glm::max(-target / attenuation.y, 0.0F);
+    }
+
+    // Constant or invalid attenuation
+    return INFINITY;
+}
+
+// Get the bounding sphere, the spotlights ambient contribution is not limited to the cone
+glm::vec4 Light::getBoundingSphere() const {
+    // Sphere around the position
+    return glm::vec4(position, getRadius());
+}
+
+
 // Setters
 
 // Set the enabled status
@@ -232,4 +276,20 @@ void Light::bind(GLSLProgram *const program) const {
         program->setUniform("u_diffuse",  glm::vec3(0.0F));
         program->setUniform("u_specular", glm::vec3(0.0F));
     }
+}
+
+
+// Static getters
+
+// Get the attenuation threshold
+float Light::getAttenuationThreshold() {
+    return Light::attenuation_threshold;
+}
+
+
+// Static setters
+
+// Set the attenuation threshold
+void Light::setAttenuationThreshold(const float &threshold) {
+    Light::attenuation_threshold = threshold;
 }
\ No newline at end of file
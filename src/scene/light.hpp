@@ -3,6 +3,7 @@
 
 #include "glslprogram.hpp"
 
+#include <glm/vec4.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec2.hpp>
 
@@ -71,6 +72,12 @@ class Light {
         float shininess;
 
 
+        // Static attributes
+
+        /** Attenuation threshold */
+        static float attenuation_threshold;
+
+
     public:
         // Constructors
 
@@ -127,6 +134,13 @@ class Light {
         float getShininess() const;
 
 
+        /** Get the effective radius */
+        float getRadius() const;
+
+        /** Get the bounding sphere, the spotlights ambient contribution is not limited to the cone */
+        glm::vec4 getBoundingSphere() const;
+
+
         // Setters
 
         /** Set the enabled status */
@@ -180,6 +194,18 @@ class Light {
 
         /** Bind the light */
         void bind(GLSLProgram *const program) const;
+
+
+        // Static getters
+
+        /** Get the attenuation threshold */
+        static float getAttenuationThreshold();
+
+
+        // Static setters
+
+        /** Set the attenuation threshold */
+        static void setAttenuationThreshold(const float &threshold);
 };
 
 #endif // __LIGHT_HPP_
\ No newline at end of file
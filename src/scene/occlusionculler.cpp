@@ -0,0 +1,251 @@
+#include "occlusionculler.hpp"
+
+#include "../job/jobsystem.hpp"
+#include "../profiler/profiler.hpp"
+
+#include <glm/common.hpp>
+#include <glm/vec4.hpp>
+
+#include <algorithm>
+
+#include <cmath>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+
+// Static const attributes
+
+// Depth buffer width
+const int OcclusionCuller::WIDTH;
+
+// Depth buffer height
+const int OcclusionCuller::HEIGHT;
+
+// Hierarchical depth tile size
+const int OcclusionCuller::TILE;
+
+// Rows of each rasterization job, a multiple of the tile size
+const int OcclusionCuller::BAND_ROWS;
+
+
+// Private methods
+
+// Clear and rasterize conservatively the triangles into a band of rows, then update its tiles
+void OcclusionCuller::rasterizeBand(const int &first_row, const int &last_row) {
+    // Clear the band
+    std::fill(depth.begin() + first_row * OcclusionCuller::WIDTH, depth.begin() + last_row * OcclusionCuller::WIDTH, INFINITY);
+
+    for (std::size_t t = 0U; t + 2U < triangle.size(); t += 3U) {
+        // Skip the triangles crossing the near plane
+        glm::vec3 v0 = triangle[t];
+        glm::vec3 v1 = triangle[t + 1U];
+        glm::vec3 v2 = triangle[t + 2U];
+        if (std::isnan(v0.z)) {
+            continue;
+        }
+
+        // Counter clockwise order, both faces are real surfaces
+        float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+        if (area < 0.0F) {
+            std::swap(v1, v2);
+            area = -area;
+        }
+        if (!(area > 0.0F)) {
+            continue;
+        }
+
+        // Bounding box clamped to the band, starting at a multiple of four columns
+        const glm::vec3 lower = glm::clamp(glm::min(glm::min(v0, v1), v2), -1.0F, static_cast<float>(OcclusionCuller::WIDTH));
+        const glm::vec3 upper = glm::clamp(glm::max(glm::max(v0, v1), v2), -1.0F, static_cast<float>(OcclusionCuller::WIDTH));
+        const int min_x = std::max(static_cast<int>(std::floor(lower.x)), 0) & ~3;
+        const int max_x = std::min(static_cast<int>(std::floor(upper.x)), OcclusionCuller::WIDTH - 1);
+        const int min_y = std::max(static_cast<int>(std::floor(lower.y)), first_row);
+        const int max_y = std::min(static_cast<int>(std::floor(upper.y)), last_row - 1);
+        if ((min_x > max_x) || (min_y > max_y)) {
+            continue;
+        }
+
+        // Edge functions steps, positive inside
+        const glm::vec3 step_x(v1.y - v2.y, v2.y - v0.y, v0.y - v1.y);
+        const glm::vec3 step_y(v2.x - v1.x, v0.x - v2.x, v1.x - v0.x);
+
+        // Edge functions and depth at the first pixel center
+        const float px = static_cast<float>(min_x) + 0.5F;
+        const float py = static_cast<float>(min_y) + 0.5F;
+        glm::vec3 edge_row(
+            (v2.x - v1.x) * (py - v1.y) - (v2.y - v1.y) * (px - v1.x),
+            (v0.x - v2.x) * (py - v2.y) - (v0.y - v2.y) * (px - v2.x),
+            (v1.x - v0.x) * (py - v0.y) - (v1.y - v0.y) * (px - v0.x));
+        const glm::vec3 z(v0.z, v1.z, v2.z);
+        const float depth_x = glm::dot(step_x, z) / area;
+        const float depth_y = glm::dot(step_y, z) / area;
+        float depth_row = glm::dot(edge_row, z) / area;
+
+        // Conservative coverage, a pixel is written only if the triangle covers all of it and with the farthest depth over it
+        edge_row -= 0.5F * (glm::abs(step_x) + glm::abs(step_y));
+        depth_row += 0.5F * (std::fabs(depth_x) + std::fabs(depth_y));
+
+        for (int y = min_y; y <= max_y; y++, edge_row += step_y, depth_row += depth_y) {
+            float *const row = &depth[static_cast<std::size_t>(y * OcclusionCuller::WIDTH)];
+
+#if defined(__SSE__)
+            // Four pixels at once
+            const __m128 lane = _mm_set_ps(3.0F, 2.0F, 1.0F, 0.0F);
+            const __m128 zero = _mm_setzero_ps();
+            __m128 edge_0 = _mm_add_ps(_mm_set1_ps(edge_row.x), _mm_mul_ps(lane, _mm_set1_ps(step_x.x)));
+            __m128 edge_1 = _mm_add_ps(_mm_set1_ps(edge_row.y), _mm_mul_ps(lane, _mm_set1_ps(step_x.y)));
+            __m128 edge_2 = _mm_add_ps(_mm_set1_ps(edge_row.z), _mm_mul_ps(lane, _mm_set1_ps(step_x.z)));
+            __m128 pixel_depth = _mm_add_ps(_mm_set1_ps(depth_row), _mm_mul_ps(lane, _mm_set1_ps(depth_x)));
+            const __m128 step_0 = _mm_set1_ps(4.0F * step_x.x);
+            const __m128 step_1 = _mm_set1_ps(4.0F * step_x.y);
+            const __m128 step_2 = _mm_set1_ps(4.0F * step_x.z);
+            const __m128 step_depth = _mm_set1_ps(4.0F * depth_x);
+
+            for (int x = min_x; x <= max_x; x += 4) {
+                // Keep the nearest depth of the pixels inside
+                const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edge_0, zero), _mm_cmpge_ps(edge_1, zero)), _mm_cmpge_ps(edge_2, zero));
+                const __m128 current = _mm_loadu_ps(row + x);
+                const __m128 nearest = _mm_min_ps(current, pixel_depth);
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+
+                // Next four pixels
+                edge_0 = _mm_add_ps(edge_0, step_0);
+                edge_1 = _mm_add_ps(edge_1, step_1);
+                edge_2 = _mm_add_ps(edge_2, step_2);
+                pixel_depth = _mm_add_ps(pixel_depth, step_depth);
+            }
+#else
+            // A pixel at once
+            glm::vec3 edge = edge_row;
+            float pixel_depth = depth_row;
+            for (int x = min_x; x <= max_x; x++, edge += step_x, pixel_depth += depth_x) {
+                if ((edge.x >= 0.0F) && (edge.y >= 0.0F) && (edge.z >= 0.0F)) {
+                    row[x] = std::min(row[x], pixel_depth);
+                }
+            }
+#endif
+        }
+    }
+
+    // Farthest depth of each tile of the band
+    for (int ty = first_row / OcclusionCuller::TILE; ty < last_row / OcclusionCuller::TILE; ty++) {
+        for (int tx = 0; tx < OcclusionCuller::WIDTH / OcclusionCuller::TILE; tx++) {
+            float farthest = -INFINITY;
+            for (int y = ty * OcclusionCuller::TILE; y < (ty + 1) * OcclusionCuller::TILE; y++) {
+                const float *const row = &depth[static_cast<std::size_t>(y * OcclusionCuller::WIDTH + tx * OcclusionCuller::TILE)];
+                farthest = std::max(farthest, *std::max_element(row, row + OcclusionCuller::TILE));
+            }
+            tile_depth[static_cast<std::size_t>(ty * (OcclusionCuller::WIDTH / OcclusionCuller::TILE) + tx)] = farthest;
+        }
+    }
+}
+
+
+// Constructor
+
+// Occlusion culler constructor
+OcclusionCuller::OcclusionCuller() :
+    depth(static_cast<std::size_t>(OcclusionCuller::WIDTH * OcclusionCuller::HEIGHT), INFINITY),
+    tile_depth(static_cast<std::size_t>((OcclusionCuller::WIDTH / OcclusionCuller::TILE) * (OcclusionCuller::HEIGHT / OcclusionCuller::TILE)), INFINITY) {}
+
+
+// Getters
+
+// Get the number of occluder triangles of the last render
+std::size_t OcclusionCuller::getTriangles() const {
+    return triangle.size() / 3U;
+}
+
+// Get the visible status of a bounding box, always visible if it crosses the near plane
+bool OcclusionCuller::isVisible(const glm::mat4 &mvp, const glm::vec3 &min, const glm::vec3 &max) const {
+    // Screen rectangle and nearest depth of the corners
+    glm::vec3 lower(INFINITY);
+    glm::vec3 upper(-INFINITY);
+    for (int i = 0; i < 8; i++) {
+        const glm::vec4 clip = mvp * glm::vec4(i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z, 1.0F);
+        if ((clip.w <= 0.0F) || (clip.z < -clip.w)) {
+            return true;
+        }
+
+        const glm::vec3 screen((clip.x / clip.w * 0.5F + 0.5F) * OcclusionCuller::WIDTH, (clip.y / clip.w * 0.5F + 0.5F) * OcclusionCuller::HEIGHT, clip.z / clip.w);
+        lower = glm::min(lower, screen);
+        upper = glm::max(upper, screen);
+    }
+
+    // Covered pixels, visible if it is out of the screen since the depth buffer can not tell
+    lower = glm::clamp(lower, -1.0F, static_cast<float>(OcclusionCuller::WIDTH));
+    upper = glm::clamp(upper, -1.0F, static_cast<float>(OcclusionCuller::WIDTH));
+    const int min_x = std::max(static_cast<int>(std::floor(lower.x)), 0);
+    const int max_x = std::min(static_cast<int>(std::floor(upper.x)), OcclusionCuller::WIDTH - 1);
+    const int min_y = std::max(static_cast<int>(std::floor(lower.y)), 0);
+    const int max_y = std::min(static_cast<int>(std::floor(upper.y)), OcclusionCuller::HEIGHT - 1);
+    if ((min_x > max_x) || (min_y > max_y)) {
+        return true;
+    }
+
+    // Skip the tiles fully in front of the box and test the pixels of the rest
+    const float nearest = lower.z;
+    for (int ty = min_y / OcclusionCuller::TILE; ty <= max_y / OcclusionCuller::TILE; ty++) {
+        for (int tx = min_x / OcclusionCuller::TILE; tx <= max_x / OcclusionCuller::TILE; tx++) {
+            if (tile_depth[static_cast<std::size_t>(ty * (OcclusionCuller::WIDTH / OcclusionCuller::TILE) + tx)] < nearest) {
+                continue;
+            }
+
+            for (int y = std::max(ty * OcclusionCuller::TILE, min_y); y <= std::min((ty + 1) * OcclusionCuller::TILE - 1, max_y); y++) {
+                for (int x = std::max(tx * OcclusionCuller::TILE, min_x); x <= std::min((tx + 1) * OcclusionCuller::TILE - 1, max_x); x++) {
+                    if (depth[static_cast<std::size_t>(y * OcclusionCuller::WIDTH + x)] >= nearest) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+
+// Methods
+
+// Render the occluders given by their model view projection matrix and triangles positions
+void OcclusionCuller::render(const std::vector<std::pair<glm::mat4, const std::vector<glm::vec3> *> > &occluder) {
+    PROFILE_ZONE("OcclusionCuller::render");
+
+    // Triangles offset of each occluder
+    std::vector<std::size_t> offset(occluder.size() + 1U, 0U);
+    for (std::size_t i = 0U; i < occluder.size(); i++) {
+        offset[i + 1U] = offset[i] + occluder[i].second->size() / 3U * 3U;
+    }
+    triangle.resize(offset.back());
+
+    // Project the occluders to the screen in parallel
+    JobSystem::parallelFor(occluder.size(), 1U, [this, &occluder, &offset] (const std::size_t &begin, const std::size_t &end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const glm::mat4 &mvp = occluder[i].first;
+            const std::vector<glm::vec3> &position = *occluder[i].second;
+            for (std::size_t t = 0U; t < offset[i + 1U] - offset[i]; t += 3U) {
+                bool crossing = false;
+                for (std::size_t j = t; j < t + 3U; j++) {
+                    const glm::vec4 clip = mvp * glm::vec4(position[j], 1.0F);
+                    crossing = crossing || (clip.w <= 0.0F) || (clip.z < -clip.w);
+                    triangle[offset[i] + j] = glm::vec3((clip.x / clip.w * 0.5F + 0.5F) * OcclusionCuller::WIDTH, (clip.y / clip.w * 0.5F + 0.5F) * OcclusionCuller::HEIGHT, clip.z / clip.w);
+                }
+
+                // Mark the triangles crossing the near plane to skip them
+                if (crossing) {
+                    triangle[offset[i] + t].z = NAN;
+                }
+            }
+        }
+    });
+
+    // Rasterize the bands in parallel
+    JobSystem::parallelFor(static_cast<std::size_t>(OcclusionCuller::HEIGHT / OcclusionCuller::BAND_ROWS), 1U, [this] (const std::size_t &begin, const std::size_t &end) {
+        for (std::size_t band = begin; band < end; band++) {
+            const int first_row = static_cast<int>(band) * OcclusionCuller::BAND_ROWS;
+            rasterizeBand(first_row, first_row + OcclusionCuller::BAND_ROWS);
+        }
+    });
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef __OCCLUSION_CULLER_HPP_
+#define __OCCLUSION_CULLER_HPP_
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <utility>
+
+#include <vector>
+
+
+/** Software depth buffer of the occluders to cull the hidden bounding boxes */
+class OcclusionCuller {
+    public:
+        // Static const attributes
+
+        /** Depth buffer width */
+        static const int WIDTH = 256;
+
+        /** Depth buffer height */
+        static const int HEIGHT = 128;
+
+        /** Hierarchical depth tile size */
+        static const int TILE = 8;
+
+
+    private:
+        // Attributes
+
+        /** Farthest depth over each pixel of the nearest occluder fully covering it */
+        std::vector<float> depth;
+
+        /** Farthest occluder depth of each tile */
+        std::vector<float> tile_depth;
+
+        /** Occluder triangles in pixels and normalized device depth, NaN depth if they cross the near plane */
+        std::vector<glm::vec3> triangle;
+
+
+        // Constructors
+
+        /** Disable the default copy constructor */
+        OcclusionCuller(const OcclusionCuller &) = delete;
+
+        /** Disable the assignation operator */
+        OcclusionCuller &operator=(const OcclusionCuller &) = delete;
+
+
+        // Methods
+
+        /** Clear and rasterize conservatively the triangles into a band of rows, then update its tiles */
+        void rasterizeBand(const int &first_row, const int &last_row);
+
+
+        // Static const attributes
+
+        /** Rows of each rasterization job, a multiple of the tile size */
+        static const int BAND_ROWS = 16;
+
+
+    public:
+        // Constructor
+
+        /** Occlusion culler constructor */
+        OcclusionCuller();
+
+
+        // Getters
+
+        /** Get the number of occluder triangles of the last render */
+        std::size_t getTriangles() const;
+
+        /** Get the visible status of a bounding box, always visible if it crosses the near plane */
+        bool isVisible(const glm::mat4 &mvp, const glm::vec3 &min, const glm::vec3 &max) const;
+
+
+        // Methods
+
+        /** Render the occluders given by their model view projection matrix and triangles positions */
+        void render(const std::vector<std::pair<glm::mat4, const std::vector<glm::vec3> *> > &occluder);
+};
+
+#endif // __OCCLUSION_CULLER_HPP_
\ No newline at end of file
@@ -0,0 +1,326 @@
+#include "pngwriter.hpp"
+
+#include <algorithm>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+
+// Private static const attributes
+
+// Deflate window size
+const std::size_t PNGWriter::WINDOW;
+
+// Hash table size of the three bytes prefixes
+const std::size_t PNGWriter::HASH_SIZE;
+
+// Maximum candidates searched per match
+const int PNGWriter::MAX_CHAIN;
+
+// Deflate length codes base lengths
+const int PNGWriter::LENGTH_BASE[] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+// Deflate length codes extra bits
+const int PNGWriter::LENGTH_EXTRA[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+// Deflate distance codes base distances
+const int PNGWriter::DISTANCE_BASE[] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+
+// Deflate distance codes extra bits
+const int PNGWriter::DISTANCE_EXTRA[] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+
+// Private static attributes
+
+// CRC-32 table
+std::uint32_t PNGWriter::crc_table[256];
+
+// CRC-32 table initialized status
+bool PNGWriter::crc_table_ready = false;
+
+
+// Private static methods
+
+// Get the CRC-32 of a buffer
+std::uint32_t PNGWriter::crc(const unsigned char *const data, const std::size_t &size) {
+    // Create the table on first use
+    if (!PNGWriter::crc_table_ready) {
+        for (std::uint32_t n = 0U; n < 256U; n++) {
+            std::uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1U) != 0U ? 0xEDB88320U ^ (c >> 1) : c >> 1;
+            }
+            PNGWriter::crc_table[n] = c;
+        }
+        PNGWriter::crc_table_ready = true;
+    }
+
+    // Compute the checksum
+    std::uint32_t c = 0xFFFFFFFFU;
+    for (std::size_t i = 0U; i < size; i++) {
+        c = PNGWriter::crc_table[(c ^ data[i]) & 0xFFU] ^ (c >> 8);
+    }
+
+    return c ^ 0xFFFFFFFFU;
+}
+
+// Append a big endian 32 bits integer
+void PNGWriter::appendUInt32(std::vector<unsigned char> &buffer, const std::uint32_t &value) {
+    buffer.push_back(static_cast<unsigned char>(value >> 24));
+    buffer.push_back(static_cast<unsigned char>(value >> 16));
+    buffer.push_back(static_cast<unsigned char>(value >> 8));
+    buffer.push_back(static_cast<unsigned char>(value));
+}
+
+// Append a chunk with its length and CRC
+void PNGWriter::appendChunk(std::vector<unsigned char> &buffer, const char *const type, const std::vector<unsigned char> &data) {
+    PNGWriter::appendUInt32(buffer, static_cast<std::uint32_t>(data.size()));
+
+    // The CRC covers the type and the data
+    const std::size_t begin = buffer.size();
+    buffer.insert(buffer.end(), type, type + 4);
+    buffer.insert(buffer.end(), data.begin(), data.end());
+    PNGWriter::appendUInt32(buffer, PNGWriter::crc(buffer.data() + begin, buffer.size() - begin));
+}
+
+
+
+// Filter a scanline with the filter of the smallest absolute sum
+void PNGWriter::filterRow(const unsigned char *const row, const unsigned char *const previous, const std::size_t &stride, std::vector<unsigned char> &filtered) {
+    // Try the none, sub, up, average and Paeth filters
+    std::vector<unsigned char> candidate(stride + 1U);
+    long best_sum = -1L;
+    for (int type = 0; type < 5; type++) {
+        candidate[0U] = static_cast<unsigned char>(type);
+        long sum = 0L;
+        for (std::size_t i = 0U; i < stride; i++) {
+            // Left, up and up left neighbours of the same channel
+            const int a = i >= 4U ? row[i - 4U] : 0;
+            const int b = previous != nullptr ? previous[i] : 0;
+            const int c = (i >= 4U) && (previous != nullptr) ? previous[i - 4U] : 0;
+
+            // Predictor of the filter
+            int predictor = 0;
+            switch (type) {
+                case 1: predictor = a; break;
+                case 2: predictor = b; break;
+                case 3: predictor = (a + b) / 2; break;
+                case 4: {
+                    const int p = a + b - c;
+                    const int pa = std::abs(p - a);
+                    const int pb = std::abs(p - b);
+                    const int pc = std::abs(p - c);
+                    predictor = (pa <= pb) && (pa <= pc) ? a : pb <= pc ? b : c;
+                }
+            }
+
+            const unsigned char value = static_cast<unsigned char>(row[i] - predictor);
+            candidate[i + 1U] = value;
+            sum += std::abs(static_cast<int>(static_cast<signed char>(value)));
+        }
+
+        // Keep the smallest sum
+        if ((best_sum < 0L) || (sum < best_sum)) {
+            best_sum = sum;
+            filtered.resize(stride + 1U);
+            std::copy(candidate.begin(), candidate.end(), filtered.begin());
+        }
+    }
+}
+
+// Write the given number of bits
+void PNGWriter::writeBits(PNGWriter::BitStream &stream, const std::uint32_t &value, const int &size) {
+    stream.bits |= value << stream.count;
+    stream.count += size;
+    while (stream.count >= 8) {
+        stream.data.push_back(static_cast<unsigned char>(stream.bits));
+        stream.bits >>= 8;
+        stream.count -= 8;
+    }
+}
+
+// Write a Huffman code, stored from the most significant bit
+void PNGWriter::writeCode(PNGWriter::BitStream &stream, const std::uint32_t &code, const int &size) {
+    std::uint32_t reversed = 0U;
+    for (int i = 0; i < size; i++) {
+        reversed |= ((code >> i) & 1U) << (size - 1 - i);
+    }
+
+    PNGWriter::writeBits(stream, reversed, size);
+}
+
+// Write a literal or length symbol with the fixed Huffman codes
+void PNGWriter::writeSymbol(PNGWriter::BitStream &stream, const int &symbol) {
+    if (symbol < 144) {
+        PNGWriter::writeCode(stream, 0x30U + static_cast<std::uint32_t>(symbol), 8);
+    }
+    else if (symbol < 256) {
+        PNGWriter::writeCode(stream, 0x190U + static_cast<std::uint32_t>(symbol - 144), 9);
+    }
+    else if (symbol < 280) {
+        PNGWriter::writeCode(stream, static_cast<std::uint32_t>(symbol - 256), 7);
+    }
+    else {
+        PNGWriter::writeCode(stream, 0xC0U + static_cast<std::uint32_t>(symbol - 280), 8);
+    }
+}
+
+// Write a match length and distance with the fixed Huffman codes
+void PNGWriter::writeMatch(PNGWriter::BitStream &stream, const int &length, const int &distance) {
+    // Length code and its extra bits
+    int code = 28;
+    while (PNGWriter::LENGTH_BASE[code] > length) {
+        code--;
+    }
+    PNGWriter::writeSymbol(stream, 257 + code);
+    PNGWriter::writeBits(stream, static_cast<std::uint32_t>(length - PNGWriter::LENGTH_BASE[code]), PNGWriter::LENGTH_EXTRA[code]);
+
+    // Distance code and its extra bits
+    code = 29;
+    while (PNGWriter::DISTANCE_BASE[code] > distance) {
+        code--;
+    }
+    PNGWriter::writeCode(stream, static_cast<std::uint32_t>(code), 5);
+    PNGWriter::writeBits(stream, static_cast<std::uint32_t>(distance - PNGWriter::DISTANCE_BASE[code]), PNGWriter::DISTANCE_EXTRA[code]);
+}
+
+// Compress a buffer into a zlib stream
+std::vector<unsigned char> PNGWriter::deflate(const std::vector<unsigned char> &raw) {
+    // Zlib header and a single final block with the fixed Huffman codes
+    PNGWriter::BitStream stream;
+    stream.data = {0x78U, 0x01U};
+    stream.bits = 0U;
+    stream.count = 0;
+    PNGWriter::writeBits(stream, 1U, 1);
+    PNGWriter::writeBits(stream, 1U, 2);
+
+    // Chains of the previous positions with the same three bytes prefix
+    const std::size_t size = raw.size();
+    std::vector<long> head(PNGWriter::HASH_SIZE, -1L);
+    std::vector<long> previous(PNGWriter::WINDOW, -1L);
+
+    std::size_t position = 0U;
+    while (position < size) {
+        // Search the longest match in the window
+        int best_length = 0;
+        int best_distance = 0;
+        std::size_t hash = 0U;
+        if (position + 3U <= size) {
+            hash = ((static_cast<std::size_t>(raw[position]) << 10U) ^ (static_cast<std::size_t>(raw[position + 1U]) << 5U) ^ raw[position + 2U]) & (PNGWriter::HASH_SIZE - 1U);
+            const std::size_t limit = std::min<std::size_t>(258U, size - position);
+            long candidate = head[hash];
+            for (int chain = 0; (chain < PNGWriter::MAX_CHAIN) && (candidate >= 0L) && (position - static_cast<std::size_t>(candidate) <= PNGWriter::WINDOW); chain++) {
+                // Skip the candidates that cannot beat the best match
+                const std::size_t first = static_cast<std::size_t>(candidate);
+                std::size_t length = 0U;
+                if ((static_cast<std::size_t>(best_length) < limit) && (raw[first + best_length] == raw[position + best_length])) {
+                    while ((length < limit) && (raw[first + length] == raw[position + length])) {
+                        length++;
+                    }
+                }
+
+                if (static_cast<int>(length) > best_length) {
+                    best_length = static_cast<int>(length);
+                    best_distance = static_cast<int>(position - first);
+                    if (length == limit) {
+                        break;
+                    }
+                }
+
+                // Older positions of the chain, stop at overwritten entries
+                const long next = previous[first % PNGWriter::WINDOW];
+                candidate = next < candidate ? next : -1L;
+            }
+        }
+
+        // Write a match or a literal
+        const std::size_t advance = best_length >= 3 ? static_cast<std::size_t>(best_length) : 1U;
+        if (best_length >= 3) {
+            PNGWriter::writeMatch(stream, best_length, best_distance);
+        }
+        else {
+            PNGWriter::writeSymbol(stream, raw[position]);
+        }
+
+        // Insert the covered positions into the chains
+        for (std::size_t end = position + advance; position < end; position++) {
+            if (position + 3U <= size) {
+                hash = ((static_cast<std::size_t>(raw[position]) << 10U) ^ (static_cast<std::size_t>(raw[position + 1U]) << 5U) ^ raw[position + 2U]) & (PNGWriter::HASH_SIZE - 1U);
+                previous[position % PNGWriter::WINDOW] = head[hash];
+                head[hash] = static_cast<long>(position);
+            }
+        }
+    }
+
+    // End of block and flush the pending bits
+    PNGWriter::writeSymbol(stream, 256);
+    PNGWriter::writeBits(stream, 0U, 7);
+
+    // Adler-32 checksum of the uncompressed data
+    std::uint32_t adler_a = 1U;
+    std::uint32_t adler_b = 0U;
+    for (const unsigned char &value : raw) {
+        adler_a = (adler_a + value) % 65521U;
+        adler_b = (adler_b + adler_a) % 65521U;
+    }
+    PNGWriter::appendUInt32(stream.data, (adler_b << 16) | adler_a);
+
+    return stream.data;
+}
+
+// Static methods
+
+// Write RGBA pixels to a PNG file, flip the rows if they are from bottom to top
+bool PNGWriter::write(const std::string &path, const int &width, const int &height, const std::vector<unsigned char> &pixels, const bool &flip) {
+    // Check the pixels size
+    const std::size_t stride = static_cast<std::size_t>(width) * 4U;
+    if ((width <= 0) || (height <= 0) || (pixels.size() < stride * static_cast<std::size_t>(height))) {
+        std::cerr << "error: invalid image size to write `" << path << "'" << std::endl;
+        return false;
+    }
+
+    // Filtered scanlines, the filters refer to the previous written row
+    std::vector<unsigned char> raw;
+    std::vector<unsigned char> filtered;
+    raw.reserve((stride + 1U) * static_cast<std::size_t>(height));
+    for (int y = 0; y < height; y++) {
+        const std::size_t row = static_cast<std::size_t>(flip ? height - 1 - y : y);
+        const std::size_t previous_row = static_cast<std::size_t>(flip ? height - y : y - 1);
+        PNGWriter::filterRow(pixels.data() + row * stride, y > 0 ? pixels.data() + previous_row * stride : nullptr, stride, filtered);
+        raw.insert(raw.end(), filtered.begin(), filtered.end());
+    }
+
+    // Compressed zlib stream
+    const std::vector<unsigned char> zlib = PNGWriter::deflate(raw);
+
+    // Header with 8 bits RGBA
+    std::vector<unsigned char> header;
+    PNGWriter::appendUInt32(header, static_cast<std::uint32_t>(width));
+    PNGWriter::appendUInt32(header, static_cast<std::uint32_t>(height));
+    header.insert(header.end(), {8U, 6U, 0U, 0U, 0U});
+
+    // Signature and chunks
+    std::vector<unsigned char> png = {0x89U, 'P', 'N', 'G', '\r', '\n', 0x1AU, '\n'};
+    PNGWriter::appendChunk(png, "IHDR", header);
+    PNGWriter::appendChunk(png, "IDAT", zlib);
+    PNGWriter::appendChunk(png, "IEND", std::vector<unsigned char>());
+
+    // Write the file
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "error: could not open the image file `" << path << "'" << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char *>(png.data()), static_cast<std::streamsize>(png.size()));
+
+    return file.good();
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef __PNG_WRITER_HPP_
+#define __PNG_WRITER_HPP_
+
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+
+/** Minimal RGBA PNG writer with filtered scanlines and fixed Huffman deflate */
+class PNGWriter {
+    private:
+        // Structs
+
+        /** Least significant bit first output stream */
+        struct BitStream {
+            /** Written bytes */
+            std::vector<unsigned char> data;
+
+            /** Pending bits */
+            std::uint32_t bits;
+
+            /** Number of pending bits */
+            int count;
+        };
+
+
+        // Static const attributes
+
+        /** Deflate window size */
+        static const std::size_t WINDOW = 32768U;
+
+        /** Hash table size of the three bytes prefixes */
+        static const std::size_t HASH_SIZE = 1U << 15U;
+
+        /** Maximum candidates searched per match */
+        static const int MAX_CHAIN = 64;
+
+        /** Deflate length codes base lengths */
+        static const int LENGTH_BASE[];
+
+        /** Deflate length codes extra bits */
+        static const int LENGTH_EXTRA[];
+
+        /** Deflate distance codes base distances */
+        static const int DISTANCE_BASE[];
+
+        /** Deflate distance codes extra bits */
+        static const int DISTANCE_EXTRA[];
+
+
+        // Static attributes
+
+        /** CRC-32 table */
+        static std::uint32_t crc_table[256];
+
+        /** CRC-32 table initialized status */
+        static bool crc_table_ready;
+
+
+        // Static methods
+
+        /** Get the CRC-32 of a buffer */
+        static std::uint32_t crc(const unsigned char *const data, const std::size_t &size);
+
+        /** Append a big endian 32 bits integer */
+        static void appendUInt32(std::vector<unsigned char> &buffer, const std::uint32_t &value);
+
+        /** Append a chunk with its length and CRC */
+        static void appendChunk(std::vector<unsigned char> &buffer, const char *const type, const std::vector<unsigned char> &data);
+
+
+        /** Filter a scanline with the filter of the smallest absolute sum */
+        static void filterRow(const unsigned char *const row, const unsigned char *const previous, const std::size_t &stride, std::vector<unsigned char> &filtered);
+
+        /** Write the given number of bits */
+        static void writeBits(PNGWriter::BitStream &stream, const std::uint32_t &value, const int &size);
+
+        /** Write a Huffman code, stored from the most significant bit */
+        static void writeCode(PNGWriter::BitStream &stream, const std::uint32_t &code, const int &size);
+
+        /** Write a literal or length symbol with the fixed Huffman codes */
+        static void writeSymbol(PNGWriter::BitStream &stream, const int &symbol);
+
+        /** Write a match length and distance with the fixed Huffman codes */
+        static void writeMatch(PNGWriter::BitStream &stream, const int &length, const int &distance);
+
+        /** Compress a buffer into a zlib stream */
+        static std::vector<unsigned char> deflate(const std::vector<unsigned char> &raw);
+
+
+    public:
+        // Constructors
+
+        /** Disable the default constructor */
+        PNGWriter() = delete;
+
+
+        // Static methods
+
+        /** Write RGBA pixels to a PNG file, flip the rows if they are from bottom to top */
+        static bool write(const std::string &path, const int &width, const int &height, const std::vector<unsigned char> &pixels, const bool &flip = true);
+};
+
+#endif // __PNG_WRITER_HPP_
\ No newline at end of file
@@ -0,0 +1,288 @@
+#include "queryculler.hpp"
+
+#include <glm/vec4.hpp>
+
+#include <utility>
+
+
+// Private static const attributes
+
+// Frames between the queries of the visible boxes
+const std::size_t QueryCuller::QUERY_INTERVAL;
+
+
+// Constructor
+
+// Query culler constructor
+QueryCuller::QueryCuller() :
+    box_vao(GL_FALSE),
+    box_vbo(GL_FALSE),
+    box_ebo(GL_FALSE) {
+    // Unit box corners
+    const float vertex[] = {
+        0.0F, 0.0F, 0.0F,
+        1.0F, 0.0F, 0.0F,
+        0.0F, 1.0F, 0.0F,
+        1.0F, 1.0F, 0.0F,
+        0.0F, 0.0F, 1.0F,
+        1.0F, 0.0F, 1.0F,
+        0.0F, 1.0F, 1.0F,
+        1.0F, 1.0F, 1.0F
+    };
+
+    // Unit box faces triangles
+    const GLubyte index[] = {
+        0U, 2U, 1U,   1U, 2U, 3U,
+        4U, 5U, 6U,   5U, 7U, 6U,
+        0U, 1U, 4U,   1U, 5U, 4U,
+        2U, 6U, 3U,   3U, 6U, 7U,
+        0U, 4U, 2U,   2U, 4U, 6U,
+        1U, 3U, 5U,   3U, 7U, 5U
+    };
+
+    // Vertex array object
+    glGenVertexArrays(1, &box_vao);
+    glBindVertexArray(box_vao);
+
+    // Vertex buffer object
+    glGenBuffers(1, &box_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, box_vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertex), &vertex, GL_STATIC_DRAW);
+
+    // Element buffer object
+    glGenBuffers(1, &box_ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, box_ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(index), &index, GL_STATIC_DRAW);
+
+    // Position attribute
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), reinterpret_cast<void *>(0));
+
+    // Unbind vertex array object
+    glBindVertexArray(GL_FALSE);
+}
+
+
+// Private methods
+
+// Issue a query drawing a bounding box with the depth program
+void QueryCuller::query(QueryCuller::Node &node, GLSLProgram *const program, const glm::mat4 &model_mat, const glm::vec3 &min, const glm::vec3 &max) {
+    // Scale and translate the unit box to the bounding box
+    glm::mat4 box_mat(1.0F);
+    box_mat[0][0] = max.x - min.x;
+    box_mat[1][1] = max.y - min.y;
+    box_mat[2][2] = max.z - min.z;
+    box_mat[3] = glm::vec4(min, 1.0F);
+    program->setUniform("u_model_mat", model_mat * box_mat);
+
+    // Draw the box inside the query
+    glBeginQuery(GL_ANY_SAMPLES_PASSED, node.query);
+    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_BYTE, reinterpret_cast<void *>(0));
+    glEndQuery(GL_ANY_SAMPLES_PASSED);
+
+    node.pending = true;
+    node.age = 0U;
+}
+
+
+// Private static methods
+
+// Generate the query of a node staggering its visible queries
+QueryCuller::Node QueryCuller::createNode(const std::size_t &index) {
+    QueryCuller::Node node;
+    glGenQueries(1, &node.query);
+    node.visible = true;
+    node.pending = false;
+    node.age = index % QueryCuller::QUERY_INTERVAL;
+    return node;
+}
+
+// Collect the result of a node without stalling, visible if it is not available yet
+void QueryCuller::collect(QueryCuller::Node &node) {
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(node.query, GL_QUERY_RESULT_AVAILABLE, &available);
+
+    if (available != GL_FALSE) {
+        GLuint passed = GL_FALSE;
+        glGetQueryObjectuiv(node.query, GL_QUERY_RESULT, &passed);
+        node.visible = passed != GL_FALSE;
+    }
+    else {
+        node.visible = true;
+    }
+
+    node.pending = false;
+}
+
+// Get the near plane crossing status of a bounding box
+bool QueryCuller::crossesNearPlane(const glm::mat4 &mvp, const glm::vec3 &min, const glm::vec3 &max) {
+    for (int i = 0; i < 8; i++) {
+        const glm::vec4 clip = mvp * glm::vec4(i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z, 1.0F);
+        if (clip.z < -clip.w) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+// Methods
+
+// Collect the previous frame results of a model and fill its objects visible status, false if the whole model is hidden
+bool QueryCuller::update(const Model *const model, const glm::mat4 &view_projection, unsigned char *const visible, std::size_t &hidden_objects) {
+    // Discard the queries of reloaded models
+    const std::size_t objects = model->getNumberOfObjects();
+    std::map<const Model *, QueryCuller::State>::iterator result = state.find(model);
+    if ((result != state.end()) && (result->second.object.size() != objects)) {
+        remove(model);
+        result = state.end();
+    }
+
+    // Create the queries of new models
+    if (result == state.end()) {
+        QueryCuller::State new_state;
+        new_state.model = QueryCuller::createNode(0U);
+        for (std::size_t i = 0U; i < objects; i++) {
+            new_state.object.push_back(QueryCuller::createNode(i));
+        }
+        result = state.insert(std::make_pair(model, new_state)).first;
+    }
+
+    QueryCuller::State &model_state = result->second;
+    model_state.mvp = view_projection * model->getModelMatrix() * model->getOriginMatrix();
+
+    // A visible box of a hidden model shows all its objects until their own queries refine them
+    if (model_state.model.pending) {
+        QueryCuller::collect(model_state.model);
+        for (QueryCuller::Node &node : model_state.object) {
+            node.visible = model_state.model.visible;
+        }
+    }
+
+    // Collect the objects results, the boxes crossing the near plane are always visible
+    model_state.model.visible = false;
+    for (std::size_t i = 0U; i < objects; i++) {
+        QueryCuller::Node &node = model_state.object[i];
+        if (node.pending) {
+            QueryCuller::collect(node);
+        }
+
+        // Empty objects are never drawn nor counted
+        const glm::vec3 min = model->getObjectMin(i);
+        const glm::vec3 max = model->getObjectMax(i);
+        if (min.x > max.x) {
+            visible[i] = 0U;
+            continue;
+        }
+
+        if (!node.visible && QueryCuller::crossesNearPlane(model_state.mvp, min, max)) {
+            node.visible = true;
+        }
+
+        visible[i] = node.visible;
+        model_state.model.visible = model_state.model.visible || node.visible;
+        hidden_objects += !node.visible;
+    }
+
+    return model_state.model.visible;
+}
+
+// Issue the queries of a model against the depth of the visible objects
+void QueryCuller::query(const Model *const model, GLSLProgram *const program) {
+    // Check the model state and program status
+    std::map<const Model *, QueryCuller::State>::iterator result = state.find(model);
+    if ((result == state.end()) || (program == nullptr) || !program->isValid()) {
+        return;
+    }
+
+    QueryCuller::State &model_state = result->second;
+    const glm::mat4 model_mat = model->getModelMatrix() * model->getOriginMatrix();
+    program->use();
+    glBindVertexArray(box_vao);
+
+    // Query the whole box of a hidden model
+    if (!model_state.model.visible && !QueryCuller::crossesNearPlane(model_state.mvp, model->getMin(), model->getMax())) {
+        query(model_state.model, program, model_mat, model->getMin(), model->getMax());
+    }
+
+    // Query the hidden objects and the visible ones after the interval
+    else {
+        for (std::size_t i = 0U; i < model_state.object.size(); i++) {
+            QueryCuller::Node &node = model_state.object[i];
+            const glm::vec3 min = model->getObjectMin(i);
+            const glm::vec3 max = model->getObjectMax(i);
+            if ((min.x > max.x) || (node.visible && (++node.age < QueryCuller::QUERY_INTERVAL))) {
+                continue;
+            }
+
+            if (!QueryCuller::crossesNearPlane(model_state.mvp, min, max)) {
+                query(node, program, model_mat, min, max);
+            }
+        }
+    }
+
+    glBindVertexArray(GL_FALSE);
+}
+
+// Draw the hidden objects of a model whose queries pass and get the number of draw calls
+std::size_t QueryCuller::drawHidden(const Model *const model, GLSLProgram *const program) const {
+    // Check the model state
+    std::map<const Model *, QueryCuller::State>::const_iterator result = state.find(model);
+    if (result == state.end()) {
+        return 0U;
+    }
+
+    // Draw the whole hidden model if its box passes, the GPU waits for the result instead of the CPU
+    const QueryCuller::State &model_state = result->second;
+    std::size_t calls = 0U;
+    if (model_state.model.pending) {
+        glBeginConditionalRender(model_state.model.query, GL_QUERY_WAIT);
+        calls = model->draw(program);
+        glEndConditionalRender();
+        return calls;
+    }
+
+    // Draw each hidden object if its box passes
+    for (std::size_t i = 0U; i < model_state.object.size(); i++) {
+        const QueryCuller::Node &node = model_state.object[i];
+        if (!node.visible && node.pending) {
+            glBeginConditionalRender(node.query, GL_QUERY_WAIT);
+            calls += model->drawObject(program, i);
+            glEndConditionalRender();
+        }
+    }
+
+    return calls;
+}
+
+// Delete the queries of a model
+void QueryCuller::remove(const Model *const model) {
+    std::map<const Model *, QueryCuller::State>::iterator result = state.find(model);
+    if (result == state.end()) {
+        return;
+    }
+
+    glDeleteQueries(1, &result->second.model.query);
+    for (const QueryCuller::Node &node : result->second.object) {
+        glDeleteQueries(1, &node.query);
+    }
+
+    state.erase(result);
+}
+
+
+// Destructor
+
+// Query culler destructor
+QueryCuller::~QueryCuller() {
+    // Delete the queries
+    while (!state.empty()) {
+        remove(state.begin()->first);
+    }
+
+    // Delete the unit box
+    glDeleteBuffers(1, &box_ebo);
+    glDeleteBuffers(1, &box_vbo);
+    glDeleteVertexArrays(1, &box_vao);
+}
\ No newline at end of file
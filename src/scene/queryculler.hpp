@@ -0,0 +1,125 @@
+#ifndef __QUERY_CULLER_HPP_
+#define __QUERY_CULLER_HPP_
+
+#include "../model/model.hpp"
+#include "glslprogram.hpp"
+
+#include "../glad/glad.h"
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include <map>
+#include <vector>
+
+
+/** Hardware occlusion queries of the bounding boxes reusing the previous frame visibility */
+class QueryCuller {
+    private:
+        // Structs
+
+        /** Bounding box query */
+        struct Node {
+            /** Any samples passed query */
+            GLuint query;
+
+            /** Last known visible status */
+            bool visible;
+
+            /** Query issued and not collected yet */
+            bool pending;
+
+            /** Frames since the last query */
+            std::size_t age;
+        };
+
+        /** Queries of a model and its objects */
+        struct State {
+            /** Model bounding box, only queried when the whole model is hidden */
+            QueryCuller::Node model;
+
+            /** Objects bounding boxes */
+            std::vector<QueryCuller::Node> object;
+
+            /** Model view projection matrix of the current frame */
+            glm::mat4 mvp;
+        };
+
+
+        // Attributes
+
+        /** Queries of each model */
+        std::map<const Model *, QueryCuller::State> state;
+
+        /** Unit box vertex array object */
+        GLuint box_vao;
+
+        /** Unit box vertex buffer object */
+        GLuint box_vbo;
+
+        /** Unit box element buffer object */
+        GLuint box_ebo;
+
+
+        // Constructors
+
+        /** Disable the default copy constructor */
+        QueryCuller(const QueryCuller &) = delete;
+
+        /** Disable the assignation operator */
+        QueryCuller &operator=(const QueryCuller &) = delete;
+
+
+        // Methods
+
+        /** Issue a query drawing a bounding box with the depth program */
+        void query(QueryCuller::Node &node, GLSLProgram *const program, const glm::mat4 &model_mat, const glm::vec3 &min, const glm::vec3 &max);
+
+
+        // Static const attributes
+
+        /** Frames between the queries of the visible boxes */
+        static const std::size_t QUERY_INTERVAL = 4U;
+
+
+        // Static methods
+
+        /** Generate the query of a node staggering its visible queries */
+        static QueryCuller::Node createNode(const std::size_t &index);
+
+        /** Collect the result of a node without stalling, visible if it is not available yet */
+        static void collect(QueryCuller::Node &node);
+
+        /** Get the near plane crossing status of a bounding box */
+        static bool crossesNearPlane(const glm::mat4 &mvp, const glm::vec3 &min, const glm::vec3 &max);
+
+
+    public:
+        // Constructor
+
+        /** Query culler constructor */
+        QueryCuller();
+
+
+        // Methods
+
+        /** Collect the previous frame results of a model and fill its objects visible status, false if the whole model is hidden */
+        bool update(const Model *const model, const glm::mat4 &view_projection, unsigned char *const visible, std::size_t &hidden_objects);
+
+        /** Issue the queries of a model against the depth of the visible objects */
+        void query(const Model *const model, GLSLProgram *const program);
+
+        /** Draw the hidden objects of a model whose queries pass and get the number of draw calls */
+        std::size_t drawHidden(const Model *const model, GLSLProgram *const program) const;
+
+        /** Delete the queries of a model */
+        void remove(const Model *const model);
+
+
+        // Destructor
+
+        /** Query culler destructor */
+        virtual ~QueryCuller();
+};
+
+#endif // __QUERY_CULLER_HPP_
\ No newline at end of file
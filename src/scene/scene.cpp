@@ -1,27 +1,49 @@
 #include "scene.hpp"
 
+#include "../job/jobsystem.hpp"
+#include "../profiler/profiler.hpp"
+
+#include <glm/common.hpp>
+#include <glm/matrix.hpp>
+#include <glm/vec2.hpp>
+
 #include <iostream>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
+#include <cmath>
+
 #define TEXTURE_BUFFERS 6
 
 
+// Private static const attributes
+
+// Events wait timeout in seconds of the idle main loops
+const double Scene::IDLE_TIMEOUT = 0.5;
+
+// Maximum models rendered as occluders per frame
+const std::size_t Scene::MAX_OCCLUDERS;
+
+
 // Private static attributes
 
 // Instances counter
 std::size_t Scene::instances = 0U;
 
-// Elements unique ID's
-std::size_t Scene::element_id = 1U;
-
 // Glad loaded flag
 bool Scene::initialized_glad = false;
 
 
-// Screen width
-GLsizei Scene::screen_width = 0U;
+// Frame buffers width
+GLsizei Scene::buffer_width = 1;
+
+// Frame buffers height
+GLsizei Scene::buffer_height = 1;
 
-// Screen
-GLsizei Scene::screen_height = 0U;
+// Render scale
+float Scene::render_scale = 1.0F;
 
 
 /** Square vertex array object */
@@ -34,12 +56,38 @@ GLuint Scene::square_vbo = GL_FALSE;
 // Geometry frame buffer object
 GLuint Scene::fbo = GL_FALSE;
 
-// Render buffer object
-GLuint Scene::rbo = GL_FALSE;
+// Depth and stencil texture
+GLuint Scene::depth_texture = GL_FALSE;
 
 // Textures buffers
 GLuint Scene::buffer_texture[TEXTURE_BUFFERS];
 
+// Buffer textures sampler names
+const GLchar *const Scene::buffer_texture_name[TEXTURE_BUFFERS] = {
+    "u_position_tex",
+    "u_normal_tex",
+    "u_ambient_tex",
+    "u_diffuse_tex",
+    "u_specular_tex",
+    "u_metadata_tex"
+};
+
+// Buffer textures requested by the lighting program
+GLuint Scene::buffer_texture_mask = (1U << TEXTURE_BUFFERS) - 1U;
+
+// Geometry buffer layout
+Scene::Layout Scene::geometry_buffer_layout = Scene::STANDARD;
+
+
+// Lighting frame buffer object
+GLuint Scene::lighting_fbo = GL_FALSE;
+
+// Lighting texture
+GLuint Scene::lighting_texture = GL_FALSE;
+
+// Lighting depth and stencil render buffer, a copy of the geometry stencil
+GLuint Scene::lighting_rbo = GL_FALSE;
+
 
 // OpenGL vendor
 const GLubyte *Scene::opengl_vendor = nullptr;
@@ -62,53 +110,84 @@ void Scene::createGeometryFrameBuffer() {
     glGenFramebuffers(1, &Scene::fbo);
     glBindFramebuffer(GL_FRAMEBUFFER, Scene::fbo);
 
-    // Generate the texture buffers and attach each one
+    // Generate the texture buffers, attached on demand of the lighting program
     glGenTextures(TEXTURE_BUFFERS, Scene::buffer_texture);
 
-    // Position texture buffer
-    Scene::attachTextureToFrameBuffer(0, GL_RGB16F, GL_RGB, GL_FLOAT);
 
-    // Normal texture buffer
-    Scene::attachTextureToFrameBuffer(1, GL_RGB16F, GL_RGB, GL_FLOAT);
+    // Depth and stencil texture
+    glGenTextures(1, &Scene::depth_texture);
+    glBindTexture(GL_TEXTURE_2D, Scene::depth_texture);
+
+    // Texture parameters
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    // Set the texture storage with stencil to mark the geometry and depth to reconstruct the position
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, Scene::buffer_width, Scene::buffer_height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, nullptr);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, Scene::depth_texture, 0);
 
-    // Ambient texture buffer
-    Scene::attachTextureToFrameBuffer(2, GL_RGB, GL_RGB, GL_UNSIGNED_BYTE);
 
-    // Diffuse and alpha texture buffer
-    Scene::attachTextureToFrameBuffer(3, GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE);
+    // Attach the texture buffers
+    Scene::setupGeometryFrameBuffer(Scene::buffer_texture_mask);
+}
 
-    // Specular texture buffer
-    Scene::attachTextureToFrameBuffer(4, GL_RGB, GL_RGB, GL_UNSIGNED_BYTE);
+// Allocate and attach the buffer textures of the given mask with the current layout
+void Scene::setupGeometryFrameBuffer(const GLuint &mask) {
+    // Internal format, format and type of each texture buffer for the standard and compact layouts
+    static const GLenum buffer_format[2][TEXTURE_BUFFERS][3] = {
+        {
+            {GL_RGB16F,  GL_RGB,  GL_FLOAT},            // Position
+            {GL_RGB16F,  GL_RGB,  GL_FLOAT},            // Normal
+            {GL_RGB,     GL_RGB,  GL_UNSIGNED_BYTE},    // Ambient
+            {GL_RGBA,    GL_RGBA, GL_UNSIGNED_BYTE},    // Diffuse and alpha
+            {GL_RGB,     GL_RGB,  GL_UNSIGNED_BYTE},    // Specular
+            {GL_RGBA16F, GL_RGBA, GL_FLOAT}             // Metadata
+        },
+        {
+            {GL_NONE,    GL_NONE, GL_NONE},             // Position from depth
+            {GL_RG16,    GL_RG,   GL_UNSIGNED_SHORT},   // Octahedral normal
+            {GL_RGB,     GL_RGB,  GL_UNSIGNED_BYTE},    // Ambient
+            {GL_RGBA,    GL_RGBA, GL_UNSIGNED_BYTE},    // Diffuse and alpha
+            {GL_RGB,     GL_RGB,  GL_UNSIGNED_BYTE},    // Specular
+            {GL_RGBA8,   GL_RGBA, GL_UNSIGNED_BYTE}     // Packed metadata
+        }
+    };
 
-    // Displacement texture buffer
-    Scene::attachTextureToFrameBuffer(5, GL_RGBA16F, GL_RGBA, GL_FLOAT);
+    // Bind the geometry frame buffer object
+    glBindFramebuffer(GL_FRAMEBUFFER, Scene::fbo);
 
+    // The compact layout does not store the position
+    const bool compact = Scene::geometry_buffer_layout == Scene::COMPACT;
+    const GLuint allocate = compact ? mask & ~1U : mask;
 
-    // Color attachments to use
+    // Attach the requested texture buffers and release the rest
     GLenum attachment[TEXTURE_BUFFERS];
     for (GLuint i = 0; i < TEXTURE_BUFFERS; i++) {
-        attachment[i] = GL_COLOR_ATTACHMENT0 + i;
+        if (allocate & (1U << i)) {
+            const GLenum *const format = buffer_format[compact][i];
+            Scene::attachTextureToFrameBuffer(i, format[0], format[1], format[2]);
+            attachment[i] = GL_COLOR_ATTACHMENT0 + i;
+        } else {
+            Scene::detachTextureFromFrameBuffer(i);
+            attachment[i] = GL_NONE;
+        }
     }
 
     // Set the list of draw buffers
     glDrawBuffers(TEXTURE_BUFFERS, attachment);
 
 
-    // Render buffer object
-    glGenRenderbuffers(1, &rbo);
-    glBindRenderbuffer(GL_RENDERBUFFER, rbo);
-
-    // Set the render buffer storage
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, Scene::screen_width, Scene::screen_height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rbo);
-
-
     // Check the geometry frame buffer creation
     const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
     if (status != GL_FRAMEBUFFER_COMPLETE) {
         std::cerr << "error: the geometry frame buffer object status is not complete (" << status << ")" <<  std::endl;
     }
 
+    // Store the requested texture buffers
+    Scene::buffer_texture_mask = mask;
+
     // Unbind geometry frame buffer object
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
@@ -125,12 +204,88 @@ void Scene::attachTextureToFrameBuffer(const GLenum &attachment, const GLint &in
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
     // Texure data
-    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, Scene::screen_width, Scene::screen_height, 0, format, type, nullptr);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, Scene::buffer_width, Scene::buffer_height, 0, format, type, nullptr);
 
     // Attach texture buffer to the frame buffer object
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + attachment, GL_TEXTURE_2D, Scene::buffer_texture[attachment], 0);
 }
 
+// Detach and release a texture of the frame buffer object
+void Scene::detachTextureFromFrameBuffer(const GLenum &attachment) {
+    // Detach texture buffer from the frame buffer object
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + attachment, GL_TEXTURE_2D, GL_FALSE, 0);
+
+    // Release the texture data
+    glBindTexture(GL_TEXTURE_2D, Scene::buffer_texture[attachment]);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+}
+
+// Resize the geometry and lighting frame buffers
+void Scene::resizeFrameBuffers(const GLsizei &width, const GLsizei &height) {
+    // Store the new resolution
+    Scene::buffer_width  = width;
+    Scene::buffer_height = height;
+
+    // Reallocate the depth and stencil texture
+    glBindTexture(GL_TEXTURE_2D, Scene::depth_texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, Scene::buffer_width, Scene::buffer_height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, nullptr);
+
+    // Reallocate the lighting texture
+    glBindTexture(GL_TEXTURE_2D, Scene::lighting_texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, Scene::buffer_width, Scene::buffer_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    // Reallocate the lighting depth and stencil render buffer
+    glBindRenderbuffer(GL_RENDERBUFFER, Scene::lighting_rbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, Scene::buffer_width, Scene::buffer_height);
+    glBindRenderbuffer(GL_RENDERBUFFER, GL_FALSE);
+
+    // Reallocate the texture buffers
+    Scene::setupGeometryFrameBuffer(Scene::buffer_texture_mask);
+}
+
+// Get a window size scaled by the render scale
+GLsizei Scene::getScaledSize(const int &size) {
+    return std::max(1, static_cast<GLsizei>(std::lround(size * Scene::render_scale)));
+}
+
+// Create the lighting frame buffer
+void Scene::createLightingFrameBuffer() {
+    // Frame buffer object
+    glGenFramebuffers(1, &Scene::lighting_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, Scene::lighting_fbo);
+
+    // Lighting texture
+    glGenTextures(1, &Scene::lighting_texture);
+    glBindTexture(GL_TEXTURE_2D, Scene::lighting_texture);
+
+    // Texture parameters
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Texture data and attachment
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, Scene::buffer_width, Scene::buffer_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, Scene::lighting_texture, 0);
+
+    // Own depth and stencil render buffer, the geometry depth texture is sampled by the lighting pass and cannot be attached
+    glGenRenderbuffers(1, &Scene::lighting_rbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, Scene::lighting_rbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, Scene::buffer_width, Scene::buffer_height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, Scene::lighting_rbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, GL_FALSE);
+
+
+    // Check the lighting frame buffer creation
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "error: the lighting frame buffer object status is not complete (" << status << ")" <<  std::endl;
+    }
+
+    // Unbind lighting frame buffer object
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
 
 // Create a square fitted to the screen
 void Scene::createSquare() {
@@ -179,119 +334,741 @@ void Scene::framebufferSizeCallback(GLFWwindow *window, int width, int height) {
 
     // Update all cameras resolution
     const glm::vec2 resolution(width, height);
-    for (const std::pair<const std::size_t, Camera *const> &camera_data : scene->camera_stock) {
+    for (const std::pair<std::size_t, Camera *> &camera_data : scene->camera_stock) {
         camera_data.second->setResolution(resolution);
     }
 }
 
+// GLFW window refresh callback
+void Scene::windowRefreshCallback(GLFWwindow *window) {
+    static_cast<Scene *>(glfwGetWindowUserPointer(window))->redraw = true;
+}
+
+
+// Combine raw data into a state signature
+void Scene::sign(std::uint64_t &signature, const void *const data, const std::size_t &size) {
+    // FNV-1a over the bytes
+    const unsigned char *const byte = static_cast<const unsigned char *>(data);
+    for (std::size_t i = 0U; i < size; i++) {
+        signature = (signature ^ byte[i]) * 1099511628211ULL;
+    }
+}
+
+// Combine the parameters and textures of a material into a state signature
+void Scene::signMaterial(std::uint64_t &signature, const Material *const material) {
+    // Missing material
+    Scene::sign(signature, &material, sizeof(material));
+    if (material == nullptr) {
+        return;
+    }
+
+    // Colors and values
+    const glm::vec3 color[] = {material->getColor(Material::AMBIENT), material->getColor(Material::DIFFUSE), material->getColor(Material::SPECULAR), material->getColor(Material::TRANSPARENCY)};
+    const float value[] = {
+        material->getValue(Material::SHININESS),
+        material->getValue(Material::ROUGHNESS),
+        material->getValue(Material::METALNESS),
+        material->getValue(Material::TRANSPARENCY),
+        material->getValue(Material::DISPLACEMENT),
+        material->getValue(Material::REFRACTIVE_INDEX)
+    };
+    Scene::sign(signature, color, sizeof(color));
+    Scene::sign(signature, value, sizeof(value));
+
+    // Textures and their enabled status
+    const Material::Attribute attribute[] = {Material::AMBIENT, Material::DIFFUSE, Material::SPECULAR, Material::SHININESS, Material::NORMAL, Material::DISPLACEMENT, Material::CUBE_MAP};
+    for (const Material::Attribute &attrib : attribute) {
+        const GLuint texture = material->getTexture(attrib);
+        const bool enabled = material->isTextureEnabled(attrib);
+        Scene::sign(signature, &texture, sizeof(texture));
+        Scene::sign(signature, &enabled, sizeof(enabled));
+    }
+}
+
 
 // Private methods
 
 // Draw the scene
 void Scene::drawScene() {
+    PROFILE_ZONE("Scene::drawScene");
+
+    // Get the lighting program
+    SlotMap<std::pair<GLSLProgram *, std::string> >::const_iterator result = program_stock.find(lighting_program);
+    GLSLProgram *const lighting = (result == program_stock.end() ? program_stock[1U] : result->second).first;
+
+    // Allocate only the texture buffers sampled by the lighting program
+    GLuint mask = 0U;
+    for (GLuint i = 0; i < TEXTURE_BUFFERS; i++) {
+        if (lighting->isUniformActive(Scene::buffer_texture_name[i])) {
+            mask |= 1U << i;
+        }
+    }
+
+    if (mask != Scene::buffer_texture_mask) {
+        Scene::setupGeometryFrameBuffer(mask);
+    }
+
+    // Resize the frame buffers to the scaled window resolution
+    const GLsizei scaled_width  = Scene::getScaledSize(width);
+    const GLsizei scaled_height = Scene::getScaledSize(height);
+    if ((scaled_width != Scene::buffer_width) || (scaled_height != Scene::buffer_height)) {
+        Scene::resizeFrameBuffers(scaled_width, scaled_height);
+    }
+
+    // Compact layout flag
+    const GLint compact = Scene::geometry_buffer_layout == Scene::COMPACT;
+
+    // Reset the draw calls counter
+    draw_calls = 0U;
+
+
     // Geometry pass
 
+    // Measure the geometry pass GPU time
+    geometry_timer->begin();
+
     // Program pointer
     GLSLProgram *program;
 
     // Bind the geometry frame buffer object
     glBindFramebuffer(GL_FRAMEBUFFER, Scene::fbo);
 
-    // Clear color and depth buffers and resize the viewport
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glViewport(0, 0, screen_width, screen_height);
+    // Mark the geometry pixels in the stencil buffer
+    glEnable(GL_STENCIL_TEST);
+    glStencilMask(0xFF);
+    glStencilFunc(GL_ALWAYS, 1, 0xFF);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+
+    // Clear color, depth and stencil buffers and resize the viewport
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    glViewport(0, 0, Scene::buffer_width, Scene::buffer_height);
+
+    // Build the draw list
+    buildDrawList();
+    const bool prepass = depth_prepass && depth_program->isValid();
+
+    // Write the depth of the opaque objects first without touching the color and stencil buffers
+    if (prepass) {
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glStencilMask(0x00);
+        active_camera->bind(depth_program);
+
+        prepass_counter->begin();
+        for (const Scene::Draw &draw : draw_list) {
+            draw_calls += draw.model->drawDepth(depth_program, object_prepass.data() + draw.first_object);
+        }
+        prepass_counter->end();
+
+        // Shade only the fragments that kept their depth
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        glStencilMask(0xFF);
+        glDepthFunc(GL_EQUAL);
+        glDepthMask(GL_FALSE);
+        geometry_counter->begin();
+    }
 
-    // Draw each model
-    for (const std::pair<const std::size_t, std::pair<const Model *const, const std::size_t> > model_data : model_stock) {
-        // Check the model status
-        if (!model_data.second.first->isOpen()) {
-            continue;
+    // Draw the visible models binding the camera and quality once per program
+    const std::vector<unsigned char> &visible = prepass ? object_prepass : object_visible;
+    program = nullptr;
+    for (const Scene::Draw &draw : draw_list) {
+        if (draw.program != program) {
+            program = draw.program;
+            active_camera->bind(program);
+            program->setUniform("u_compact", compact);
+            program->setUniform("u_max_layers", governor.getMaxLayers());
+            program->setUniform("u_min_layers", governor.getMinLayers());
+            program->setUniform("u_lod_bias", governor.getLODBias());
         }
 
-        // Get the program
-        std::map<std::size_t, std::pair<GLSLProgram *, std::string> >::const_iterator result = program_stock.find(model_data.second.second);
-        program = (result == program_stock.end() ? program_stock[0U] : result->second).first;
+        // Draw the model
+        draw_calls += draw.model->draw(program, visible.data() + draw.first_object);
+    }
+
+    // Draw the objects left out of the pre-pass with the usual depth test
+    if (prepass) {
+        geometry_counter->end();
+        glDepthFunc(GL_LESS);
+        glDepthMask(GL_TRUE);
 
-        // Bind the camera
-        active_camera->bind(program);
+        for (const Scene::Draw &draw : draw_list) {
+            if (draw.late) {
+                draw_calls += draw.model->draw(draw.program, object_late.data() + draw.first_object);
+            }
+        }
+    }
 
-        // Draw the model
-        model_data.second.first->draw(program);
+    // Draw the objects hidden in the previous frame that became visible
+    if ((culling == Scene::HARDWARE_OCCLUSION) && depth_program->isValid()) {
+        drawOcclusionQueries();
     }
 
+    // Finish the geometry pass GPU time
+    geometry_timer->end();
 
-    // Lighting pass
 
-    // Bind the default frame buffer
-    glBindFramebuffer(GL_FRAMEBUFFER, GL_FALSE);
+    // Lighting pass
 
-    // Setup for add the lights contribution
+    // Copy the geometry stencil to the lighting frame buffer and bind it
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, Scene::fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, Scene::lighting_fbo);
+    glStencilMask(0xFF);
+    glBlitFramebuffer(0, 0, Scene::buffer_width, Scene::buffer_height, 0, 0, Scene::buffer_width, Scene::buffer_height, GL_STENCIL_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, Scene::lighting_fbo);
+
+    // Write the background color once
+    background_timer->begin();
+    glClearColor(background_color.r, background_color.g, background_color.b, 1.0F);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glClearColor(0.0F, 0.0F, 0.0F, 0.0F);
+    background_timer->end();
+
+    // Only shade the pixels marked as geometry
+    glStencilMask(0x00);
+    glStencilFunc(GL_EQUAL, 1, 0xFF);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+
+    // Setup for replace the background with the first light and add the next lights contribution
     glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
+    glDepthMask(GL_FALSE);
+    glDisable(GL_BLEND);
     glBlendFunc(GL_ONE, GL_ONE);
 
-    // Clear color and depth buffers and resize the viewport
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glViewport(0, 0, width, height);
-
-    // Get the program and use it
-    std::map<std::size_t, std::pair<GLSLProgram *, std::string> >::const_iterator result = program_stock.find(lighting_program);
-    program = (result == program_stock.end() ? program_stock[1U] : result->second).first;
-
-    // Set the view position
+    // Use the lighting program
+    program = lighting;
     program->use();
-    program->setUniform("u_view_pos", active_camera->getPosition());
 
-    // Set buffer texture uniforms
-    program->setUniform("u_position_tex", 0);
-    program->setUniform("u_normal_tex",   1);
-    program->setUniform("u_ambient_tex",  2);
-    program->setUniform("u_diffuse_tex",  3);
-    program->setUniform("u_specular_tex", 4);
-    program->setUniform("u_metadata_tex", 5);
+    // Set the view position and the inverse view projection matrix to reconstruct the compact position
+    program->setUniform("u_view_pos", active_camera->getPosition());
+    program->setUniform("u_inv_view_projection_mat", glm::inverse(active_camera->getProjectionMatrix() * active_camera->getViewMatrix()));
+    program->setUniform("u_compact", compact);
 
-    // Bind buffer textures
-    for (GLenum i = 0; i < TEXTURE_BUFFERS; i++) {
+    // Set buffer texture uniforms and bind the buffer textures
+    for (GLint i = 0; i < TEXTURE_BUFFERS; i++) {
+        program->setUniform(Scene::buffer_texture_name[i], i);
         glActiveTexture(GL_TEXTURE0 + i);
         glBindTexture(GL_TEXTURE_2D, Scene::buffer_texture[i]);
     }
 
+    // Set and bind the depth texture
+    program->setUniform("u_depth_tex", TEXTURE_BUFFERS);
+    glActiveTexture(GL_TEXTURE0 + TEXTURE_BUFFERS);
+    glBindTexture(GL_TEXTURE_2D, Scene::depth_texture);
+
     // Bind the square vertex array object
     glBindVertexArray(Scene::square_vao);
 
     // For each light
     int pass = 0;
-    for (const std::pair<const std::size_t, const Light *const> &light_data : light_stock) {
-        // Set the propper background color
-        if (pass < 2) {
-            program->setUniform("u_background_color", pass == 0 ? background_color : glm::vec3(0.0F));
+    glm::ivec4 scissor;
+    for (const std::pair<std::size_t, Light *> &light_data : light_stock) {
+        // Get the light GPU timer
+        GPUTimer *&timer = light_timer[light_data.first];
+        if (timer == nullptr) {
+            timer = new GPUTimer();
+        }
+
+        // The first pass replaces the background over all the geometry
+        if (pass == 0) {
             pass++;
         }
 
-        // Bind light and draw square
+        // Skip lights out of view and add the rest scissored to their volume
+        else {
+            if (!light_data.second->isEnabled() || !getLightScissor(light_data.second, scissor)) {
+                timer->skip();
+                continue;
+            }
+
+            // Enable the blending and scissor test for the second pass
+            if (pass == 1) {
+                glEnable(GL_BLEND);
+                glEnable(GL_SCISSOR_TEST);
+                pass++;
+            }
+
+            glScissor(scissor.x, scissor.y, scissor.z, scissor.w);
+        }
+
+        // Bind light and draw square measuring its GPU time
+        timer->begin();
         light_data.second->bind(program);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        draw_calls++;
+        timer->end();
     }
 
-    // Unbind square vertex array
+    // Unbind square vertex array and disable the scissor and stencil tests
     glBindVertexArray(GL_FALSE);
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_STENCIL_TEST);
 
     // Disable the lights contribution
     glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
     glDisable(GL_BLEND);
+
+
+    // Composite pass
+    compositeScene();
+}
+
+// Copy and upscale the last lighting image to the target frame buffer
+void Scene::compositeScene() {
+    composite_timer->begin();
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, Scene::lighting_fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target_fbo);
+    glBlitFramebuffer(0, 0, Scene::buffer_width, Scene::buffer_height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, target_fbo);
+    glViewport(0, 0, width, height);
+    composite_timer->end();
+}
+
+// Build the sorted draw list of the models inside the view frustum
+void Scene::buildDrawList() {
+    PROFILE_ZONE("Scene::buildDrawList");
+
+    // Test the models bounding boxes in parallel, the matrices of each model are only touched by one job
+    const glm::mat4 view_projection = active_camera->getProjectionMatrix() * active_camera->getViewMatrix();
+    const std::size_t count = model_stock.size();
+    std::vector<Scene::Draw> candidate(count);
+    JobSystem::parallelFor(count, 64U, [this, &view_projection, &candidate] (const std::size_t &begin, const std::size_t &end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const std::pair<Model *, std::size_t> &model_data = (model_stock.begin() + static_cast<std::ptrdiff_t>(i))->second;
+            Scene::Draw &draw = candidate[i];
+            draw.model = nullptr;
+
+            // Check the model status
+            Model *const model = model_data.first;
+            if (!model->isEnabled() || !model->isOpen()) {
+                continue;
+            }
+
+            // Project the bounding box corners counting the ones outside each clip plane
+            const glm::mat4 mvp = view_projection * model->getModelMatrix() * model->getOriginMatrix();
+            const glm::vec3 min = model->getMin();
+            const glm::vec3 max = model->getMax();
+            int outside[6] = {0, 0, 0, 0, 0, 0};
+            glm::vec2 ndc_min(INFINITY);
+            glm::vec2 ndc_max(-INFINITY);
+            bool behind = false;
+            for (int j = 0; j < 8; j++) {
+                const glm::vec4 clip = mvp * glm::vec4(j & 1 ? max.x : min.x, j & 2 ? max.y : min.y, j & 4 ? max.z : min.z, 1.0F);
+                if (clip.w > 0.0F) {
+                    ndc_min = glm::min(ndc_min, glm::vec2(clip) / clip.w);
+                    ndc_max = glm::max(ndc_max, glm::vec2(clip) / clip.w);
+                }
+                else {
+                    behind = true;
+                }
+                outside[0] += clip.x < -clip.w;
+                outside[1] += clip.x >  clip.w;
+                outside[2] += clip.y < -clip.w;
+                outside[3] += clip.y >  clip.w;
+                outside[4] += clip.z < -clip.w;
+                outside[5] += clip.z >  clip.w;
+            }
+
+            // Cull the models with all the corners outside the same plane
+            if ((outside[0] == 8) || (outside[1] == 8) || (outside[2] == 8) || (outside[3] == 8) || (outside[4] == 8) || (outside[5] == 8)) {
+                continue;
+            }
+
+            // Get the program, the depth of the center and the screen area of the box
+            const SlotMap<std::pair<GLSLProgram *, std::string> >::const_iterator result = program_stock.find(model_data.second);
+            draw.model = model;
+            draw.program = (result == program_stock.end() ? program_stock[0U] : result->second).first;
+            draw.depth = (mvp * glm::vec4((min + max) / 2.0F, 1.0F)).w;
+            draw.area = behind ? INFINITY : (ndc_max.x - ndc_min.x) * (ndc_max.y - ndc_min.y);
+            draw.first_object = 0U;
+            draw.late = false;
+        }
+    });
+
+    // Keep the models inside the frustum
+    draw_list.clear();
+    for (const Scene::Draw &draw : candidate) {
+        if (draw.model != nullptr) {
+            draw_list.push_back(draw);
+        }
+    }
+
+    // Generate the tangents of the models drawn by a program reading them for the first time
+    for (const Scene::Draw &draw : draw_list) {
+        if (draw.program->isAttributeActive("l_tangent")) {
+            draw.model->loadTangents();
+        }
+    }
+
+    // Assign the objects visible status ranges
+    std::size_t objects = 0U;
+    for (Scene::Draw &draw : draw_list) {
+        draw.first_object = objects;
+        objects += draw.model->getNumberOfObjects();
+    }
+    object_visible.assign(objects, 1U);
+
+    // Cull the models and objects hidden by the largest ones or by the previous frame queries
+    occluded_models = 0U;
+    occluded_objects = 0U;
+    if (culling == Scene::SOFTWARE_OCCLUSION) {
+        cullOccludedModels(view_projection);
+    }
+    else if ((culling == Scene::HARDWARE_OCCLUSION) && depth_program->isValid()) {
+        collectOcclusionQueries(view_projection);
+    }
+
+    // Fraction of the objects hidden by occlusion, the empty objects are not flagged as visible nor occluded
+    const std::size_t shown = static_cast<std::size_t>(std::count(object_visible.begin(), object_visible.end(), static_cast<unsigned char>(1U)));
+    occluded_fraction = occluded_objects == 0U ? 0.0F : static_cast<float>(occluded_objects) / static_cast<float>(occluded_objects + shown);
+
+    // Split the objects for the depth pre-pass
+    if (depth_prepass && depth_program->isValid()) {
+        splitDepthPrepass();
+    }
+
+    // Sort by program to minimize the state changes, then front to back
+    std::sort(draw_list.begin(), draw_list.end(), [] (const Scene::Draw &a, const Scene::Draw &b) {
+        return a.program == b.program ? a.depth < b.depth : std::less<GLSLProgram *>()(a.program, b.program);
+    });
+}
+
+// Cull the models and objects of the draw list hidden by the largest models
+void Scene::cullOccludedModels(const glm::mat4 &view_projection) {
+    PROFILE_ZONE("Scene::cullOccludedModels");
+
+    // Pick the largest models on screen as occluders, the parallax programs discard the silhouette texels
+    std::vector<Scene::Draw> largest;
+    for (const Scene::Draw &draw : draw_list) {
+        if (!draw.program->isUniformActive("u_displacement_tex")) {
+            largest.push_back(draw);
+        }
+    }
+    const std::size_t occluders = std::min(largest.size(), Scene::MAX_OCCLUDERS);
+    std::partial_sort(largest.begin(), largest.begin() + static_cast<std::ptrdiff_t>(occluders), largest.end(), [] (const Scene::Draw &a, const Scene::Draw &b) {
+        return a.area > b.area;
+    });
+
+    std::vector<std::pair<glm::mat4, const std::vector<glm::vec3> *> > occluder;
+    for (std::size_t i = 0U; i < occluders; i++) {
+        const Model *const model = largest[i].model;
+        if (!model->getOccluder().empty()) {
+            occluder.push_back(std::make_pair(view_projection * model->getModelMatrix() * model->getOriginMatrix(), &model->getOccluder()));
+        }
+    }
+
+    // Render the occluders depth
+    occlusion_culler.render(occluder);
+
+    // Test the models and then their objects in parallel, each job writes its own ranges
+    std::atomic<std::size_t> hidden_models(0U);
+    std::atomic<std::size_t> hidden_objects(0U);
+    JobSystem::parallelFor(draw_list.size(), 16U, [this, &view_projection, &hidden_models, &hidden_objects] (const std::size_t &begin, const std::size_t &end) {
+        for (std::size_t i = begin; i < end; i++) {
+            Scene::Draw &draw = draw_list[i];
+            const glm::mat4 mvp = view_projection * draw.model->getModelMatrix() * draw.model->getOriginMatrix();
+            const bool model_visible = occlusion_culler.isVisible(mvp, draw.model->getMin(), draw.model->getMax());
+
+            // Empty objects are never drawn nor counted
+            unsigned char *const visible = object_visible.data() + draw.first_object;
+            std::size_t shown = 0U;
+            for (std::size_t j = 0U; j < draw.model->getNumberOfObjects(); j++) {
+                const glm::vec3 min = draw.model->getObjectMin(j);
+                const glm::vec3 max = draw.model->getObjectMax(j);
+                if (min.x > max.x) {
+                    visible[j] = 0U;
+                }
+                else if (model_visible && occlusion_culler.isVisible(mvp, min, max)) {
+                    shown++;
+                }
+                else {
+                    visible[j] = 0U;
+                    hidden_objects++;
+                }
+            }
+
+            // All the objects of the model are hidden
+            if (shown == 0U) {
+                draw.model = nullptr;
+                hidden_models++;
+            }
+        }
+    });
+
+    // Remove the hidden models
+    draw_list.erase(std::remove_if(draw_list.begin(), draw_list.end(), [] (const Scene::Draw &draw) {
+        return draw.model == nullptr;
+    }), draw_list.end());
+
+    occluded_models = hidden_models;
+    occluded_objects = hidden_objects;
+}
+
+// Collect the previous frame occlusion queries of the draw list
+void Scene::collectOcclusionQueries(const glm::mat4 &view_projection) {
+    PROFILE_ZONE("Scene::collectOcclusionQueries");
+
+    // The hidden models stay in the draw list to be drawn if their boxes pass
+    for (const Scene::Draw &draw : draw_list) {
+        if (!query_culler->update(draw.model, view_projection, object_visible.data() + draw.first_object, occluded_objects)) {
+            occluded_models++;
+        }
+    }
+}
+
+// Query the bounding boxes of the draw list and draw the hidden objects whose boxes pass
+void Scene::drawOcclusionQueries() {
+    PROFILE_ZONE("Scene::drawOcclusionQueries");
+
+    // Test the boxes against the depth of the visible objects without writing any buffer
+    active_camera->bind(depth_program);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_FALSE);
+    glStencilMask(0x00);
+    glDepthFunc(GL_LEQUAL);
+
+    for (const Scene::Draw &draw : draw_list) {
+        query_culler->query(draw.model, depth_program);
+    }
+
+    glDepthFunc(GL_LESS);
+    glStencilMask(0xFF);
+    glDepthMask(GL_TRUE);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+    // Draw the objects hidden in the previous frame, the programs keep the uniforms of the first loop
+    for (const Scene::Draw &draw : draw_list) {
+        draw_calls += query_culler->drawHidden(draw.model, draw.program);
+    }
+}
+
+// Split the visible objects of the draw list between the depth pre-pass and the late draws
+void Scene::splitDepthPrepass() {
+    object_prepass.assign(object_visible.size(), 0U);
+    object_late.assign(object_visible.size(), 0U);
+
+    // The discarded fragments must not write depth, so the alpha tested materials and the parallax programs are drawn late
+    for (Scene::Draw &draw : draw_list) {
+        const bool program_prepass = !draw.program->isUniformActive("u_displacement_tex");
+        draw.late = false;
+        for (std::size_t i = 0U; i < draw.model->getNumberOfObjects(); i++) {
+            const std::size_t index = draw.first_object + i;
+            if (object_visible[index] == 0U) {
+                continue;
+            }
+
+            if (program_prepass && draw.model->isObjectOpaque(i)) {
+                object_prepass[index] = 1U;
+            }
+            else {
+                object_late[index] = 1U;
+                draw.late = true;
+            }
+        }
+    }
+}
+
+// Update the scene state signature, true if the scene has to be redrawn
+bool Scene::updateStateSignature() {
+    // Rebuild the outdated model matrices in parallel before reading them
+    JobSystem::parallelFor(model_stock.size(), 64U, [this] (const std::size_t &begin, const std::size_t &end) {
+        for (std::size_t i = begin; i < end; i++) {
+            (model_stock.begin() + static_cast<std::ptrdiff_t>(i))->second.first->getModelMatrix();
+        }
+    });
+
+    // FNV-1a offset basis
+    std::uint64_t signature = 14695981039346656037ULL;
+
+    // Resolution, frame buffers setup and background
+    Scene::sign(signature, &width, sizeof(width));
+    Scene::sign(signature, &height, sizeof(height));
+    Scene::sign(signature, &Scene::render_scale, sizeof(Scene::render_scale));
+    Scene::sign(signature, &Scene::geometry_buffer_layout, sizeof(Scene::geometry_buffer_layout));
+    Scene::sign(signature, &background_color, sizeof(background_color));
+    Scene::sign(signature, &lighting_program, sizeof(lighting_program));
+
+    // Governor quality
+    const glm::vec3 quality(governor.getMaxLayers(), governor.getMinLayers(), governor.getLODBias());
+    Scene::sign(signature, &quality, sizeof(quality));
+
+    // Active camera
+    const glm::mat4 view_projection = active_camera->getProjectionMatrix() * active_camera->getViewMatrix();
+    Scene::sign(signature, &active_camera, sizeof(active_camera));
+    Scene::sign(signature, &view_projection, sizeof(view_projection));
+
+    // Models transforms, programs, tangents and materials
+    for (const std::pair<std::size_t, std::pair<Model *, std::size_t> > &model_data : model_stock) {
+        const Model *const model = model_data.second.first;
+        const bool status[] = {model->isEnabled(), model->isOpen(), model->hasTangents()};
+        const glm::mat4 model_matrix = model->getModelMatrix();
+        Scene::sign(signature, &model_data.first, sizeof(model_data.first));
+        Scene::sign(signature, &model_data.second.second, sizeof(model_data.second.second));
+        Scene::sign(signature, &model, sizeof(model));
+        Scene::sign(signature, status, sizeof(status));
+        Scene::sign(signature, &model_matrix, sizeof(model_matrix));
+
+        // Materials, the default one included
+        const std::size_t materials = model->getNumberOfMaterials();
+        for (std::size_t i = 0U; i < materials; i++) {
+            Scene::signMaterial(signature, model->getMaterial(i));
+        }
+        Scene::signMaterial(signature, model->getDefaultMaterial());
+    }
+
+    // Lights
+    for (const std::pair<std::size_t, Light *> &light_data : light_stock) {
+        const Light *const light = light_data.second;
+        const bool enabled = light->isEnabled();
+        const Light::Type type = light->getType();
+        const glm::vec3 vector[] = {light->getPosition(), light->getDirection(), light->getAttenuation(), light->getAmbientColor(), light->getDiffuseColor(), light->getSpecularColor()};
+        const glm::vec2 cutoff = light->getCutoff();
+        const glm::vec4 level(light->getAmbientLevel(), light->getDiffuseLevel(), light->getSpecularLevel(), light->getShininess());
+        Scene::sign(signature, &light_data.first, sizeof(light_data.first));
+        Scene::sign(signature, &enabled, sizeof(enabled));
+        Scene::sign(signature, &type, sizeof(type));
+        Scene::sign(signature, vector, sizeof(vector));
+        Scene::sign(signature, &cutoff, sizeof(cutoff));
+        Scene::sign(signature, &level, sizeof(level));
+    }
+
+    // Compare against the last drawn scene
+    const bool changed = redraw || (signature != state_signature);
+    state_signature = signature;
+    redraw = false;
+
+    return changed;
+}
+
+
+// Get the scissor rectangle of a light, false if the light is out of view
+bool Scene::getLightScissor(const Light *const light, glm::ivec4 &rect) const {
+    // Full screen rectangle by default
+    rect = glm::ivec4(0, 0, Scene::buffer_width, Scene::buffer_height);
+
+    // Get the light bounding sphere and keep the full screen for unbounded lights
+    const glm::vec4 sphere = light->getBoundingSphere();
+    if (!std::isfinite(sphere.w)) {
+        return true;
+    }
+
+    // Project the corners of the sphere bounding box
+    const glm::mat4 view_projection_mat = active_camera->getProjectionMatrix() * active_camera->getViewMatrix();
+    glm::vec3 min(INFINITY);
+    glm::vec3 max(-INFINITY);
+    int behind = 0;
+    for (int i = 0; i < 8; i++) {
+        const glm::vec3 corner(sphere.x + (i & 1 ? sphere.w : -sphere.w), sphere.y + (i & 2 ? sphere.w : -sphere.w), sphere.z + (i & 4 ? sphere.w : -sphere.w));
+        const glm::vec4 clip = view_projection_mat * glm::vec4(corner, 1.0F);
+
+        // Corners behind the eye cannot be projected
+        if (clip.w <= 0.0F) {
+            behind++;
+            continue;
+        }
+
+        // Update the normalized device coordinates limits
+        const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        min = glm::min(min, ndc);
+        max = glm::max(max, ndc);
+    }
+
+    // Cull lights fully behind the eye and keep the full screen for lights crossing the eye plane
+    if (behind == 8) {
+        return false;
+    }
+    if (behind > 0) {
+        return true;
+    }
+
+    // Cull lights out of the view frustum
+    if ((max.x < -1.0F) || (min.x > 1.0F) || (max.y < -1.0F) || (min.y > 1.0F) || (max.z < -1.0F) || (min.z > 1.0F)) {
+        return false;
+    }
+
+    // Rectangle in window coordinates
+    min = glm::clamp(min, -1.0F, 1.0F) * 0.5F + 0.5F;
+    max = glm::clamp(max, -1.0F, 1.0F) * 0.5F + 0.5F;
+    rect.x = static_cast<GLint>(std::floor(min.x * Scene::buffer_width));
+    rect.y = static_cast<GLint>(std::floor(min.y * Scene::buffer_height));
+    rect.z = static_cast<GLint>(std::ceil(max.x * Scene::buffer_width)) - rect.x;
+    rect.w = static_cast<GLint>(std::ceil(max.y * Scene::buffer_height)) - rect.y;
+
+    // Return true if the rectangle is not empty
+    return (rect.z > 0) && (rect.w > 0);
+}
+
+
+// Get the last frame GPU time in milliseconds
+double Scene::getGPUFrameTime() const {
+    // Passes GPU time
+    double time = geometry_timer->getElapsed() + background_timer->getElapsed() + composite_timer->getElapsed();
+
+    // Add the lights GPU time
+    for (const std::pair<const std::size_t, GPUTimer *> &timer_data : light_timer) {
+        time += timer_data.second->getElapsed();
+    }
+
+    return time;
+}
+
+// Record the frame times and update the governor with the frame CPU time in seconds
+void Scene::updateFrameTiming(const double &cpu_time) {
+    // Record the frame times in milliseconds
+    const double cpu = cpu_time * 1000.0;
+    const double gpu = getGPUFrameTime();
+    frame_stats.record(cpu, gpu);
+
+    // Follow the render scale of the governor quality
+    if (governor.update(cpu, gpu)) {
+        Scene::setRenderScale(governor.getRenderScale());
+    }
+}
+
+
+// Create the offscreen target frame buffer
+bool Scene::createTargetFrameBuffer() {
+    // Frame buffer object
+    glGenFramebuffers(1, &target_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, target_fbo);
+
+    // Color render buffer with the scene resolution
+    glGenRenderbuffers(1, &target_rbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, target_rbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target_rbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    // Check the target frame buffer creation
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "error: the target frame buffer object status is not complete (" << status << ")" <<  std::endl;
+        glDeleteRenderbuffers(1, &target_rbo);
+        glDeleteFramebuffers(1, &target_fbo);
+        target_rbo = GL_FALSE;
+        target_fbo = GL_FALSE;
+        return false;
+    }
+
+    return true;
 }
 
 
 // Constructor
 
 // Scene constructor
-Scene::Scene(const std::string &title, const int &width, const int &height, const int &context_ver_maj, const int &context_ver_min) :
+Scene::Scene(const std::string &title, const int &width, const int &height, const int &context_ver_maj, const int &context_ver_min, const bool &headless) :
     // Defaults for window
     window(nullptr),
     title(title),
     width(width),
     height(height),
 
+    // Target frame buffer
+    headless(headless),
+    target_fbo(GL_FALSE),
+    target_rbo(GL_FALSE),
+
     // Clear color
     background_color(0.0F),
 
@@ -299,7 +1076,35 @@ Scene::Scene(const std::string &title, const int &width, const int &height, cons
     active_camera(nullptr),
 
     // Geometry pass program ID
-    lighting_program(1U) {
+    lighting_program(1U),
+
+    // Programs IDs start from zero for the default programs
+    program_stock(0U),
+
+    // Frame timing
+    draw_calls(0U),
+    vsync(true),
+
+    // Occlusion culling
+    culling(Scene::FRUSTUM_CULLING),
+    query_culler(nullptr),
+    depth_program(nullptr),
+    occluded_models(0U),
+    occluded_objects(0U),
+    occluded_fraction(0.0F),
+
+    // Depth pre-pass
+    depth_prepass(false),
+    prepass_counter(nullptr),
+    geometry_counter(nullptr),
+
+    geometry_timer(nullptr),
+    background_timer(nullptr),
+    composite_timer(nullptr),
+
+    // Draw the first frame
+    redraw(true),
+    state_signature(0U) {
     // Create window flag
     bool create_window = true;
 
@@ -308,6 +1113,13 @@ Scene::Scene(const std::string &title, const int &width, const int &height, cons
         // Setup error callback
         glfwSetErrorCallback(Scene::errorCallback);
 
+        // Use the null platform for headless scenes, no display server is required
+#ifdef GLFW_PLATFORM_NULL
+        if (headless) {
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        }
+#endif
+
         // Initialize the library
         if (glfwInit() != GLFW_TRUE) {
             std::cerr << "error: cannot initialize GLFW" << std::endl;
@@ -321,16 +1133,35 @@ Scene::Scene(const std::string &title, const int &width, const int &height, cons
         glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, context_ver_maj);
         glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, context_ver_min);
         glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_VISIBLE, headless ? GLFW_FALSE : GLFW_TRUE);
+
+        // Headless scenes use an offscreen context API
+        if (headless) {
+#ifdef GLFW_OSMESA_CONTEXT_API
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+#else
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+#endif
+        }
 
         // Create the scene window
         window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
 
+        // Fallback to EGL if the headless window could not be created
+        if ((window == nullptr) && headless) {
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+            window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
+        }
+
+        // Restore the default hints for the next windows
+        glfwDefaultWindowHints();
+
         // Create the default camera
         active_camera = new Camera(width, height);
-        camera_stock[Scene::element_id++] = active_camera;
+        camera_stock.insert(active_camera);
 
         // Add one light into the light stock
-        light_stock[Scene::element_id++] = new Light();
+        light_stock.insert(new Light());
     }
 
     // Check the window creation
@@ -340,12 +1171,17 @@ Scene::Scene(const std::string &title, const int &width, const int &height, cons
 
     // Setup the context
     else {
-        // Set the user pointer to this scene and setup callbacks
+        // Set the user pointer to this scene
         glfwSetWindowUserPointer(window, this);
-        glfwSetFramebufferSizeCallback(window, Scene::framebufferSizeCallback);
 
-        // Maximize window and setup as the current context
-        glfwMaximizeWindow(window);
+        // Setup callbacks and maximize only visible windows
+        if (!headless) {
+            glfwSetFramebufferSizeCallback(window, Scene::framebufferSizeCallback);
+            glfwSetWindowRefreshCallback(window, Scene::windowRefreshCallback);
+            glfwMaximizeWindow(window);
+        }
+
+        // Setup as the current context
         glfwMakeContextCurrent(window);
 
         // Initialize Glad and check errors
@@ -369,25 +1205,47 @@ Scene::Scene(const std::string &title, const int &width, const int &height, cons
             Scene::glsl_version    = glGetString(GL_SHADING_LANGUAGE_VERSION);
 
             // Setup the swap interval
-            glfwSwapInterval(1);
+            glfwSwapInterval(vsync);
+
+            // Create the passes GPU timers
+            geometry_timer   = new GPUTimer();
+            background_timer = new GPUTimer();
+            composite_timer  = new GPUTimer();
+
+            // Create the occlusion queries culler and its empty depth only program
+            query_culler  = new QueryCuller();
+            depth_program = new GLSLProgram();
+
+            // Create the depth pre-pass fragments counters
+            prepass_counter  = new FragmentCounter();
+            geometry_counter = new FragmentCounter();
+
+            // Create the offscreen target frame buffer
+            if (headless && !createTargetFrameBuffer()) {
+                std::cerr << "error: cannot create the headless target frame buffer" << std::endl;
+            }
 
             // Enable depth test
             glEnable(GL_DEPTH_TEST);
 
-            // Create a empty default geometry pass program
-            program_stock[0U] = std::pair<GLSLProgram *, std::string>(new GLSLProgram(), "Empty (Default geometry pass)");
+            // Create a empty default geometry pass program, the first ID is zero
+            program_stock.insert(std::pair<GLSLProgram *, std::string>(new GLSLProgram(), "Empty (Default geometry pass)"));
 
-            // Create a empty default lighting pass program
-            program_stock[1U] = std::pair<GLSLProgram *, std::string>(new GLSLProgram(), "Empty (Default lighting pass)");
+            // Create a empty default lighting pass program, the second ID is one
+            program_stock.insert(std::pair<GLSLProgram *, std::string>(new GLSLProgram(), "Empty (Default lighting pass)"));
         }
     }
 
     // If there are no instances
     if ((Scene::instances == 0U) && Scene::initialized_glad) {
-        // Get the screen resolution
-        const GLFWvidmode *const video_mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
-        Scene::screen_width = video_mode->width;
-        Scene::screen_height = video_mode->height;
+        // Get the frame buffers resolution from the window or the target frame buffer
+        int window_width = width;
+        int window_height = height;
+        if (!headless) {
+            glfwGetFramebufferSize(window, &window_width, &window_height);
+        }
+        Scene::buffer_width  = Scene::getScaledSize(window_width);
+        Scene::buffer_height = Scene::getScaledSize(window_height);
 
         // Create the square to deferred shading
         Scene::createSquare();
@@ -395,6 +1253,9 @@ Scene::Scene(const std::string &title, const int &width, const int &height, cons
         // Create the geometry frame buffer
         Scene::createGeometryFrameBuffer();
 
+        // Create the lighting frame buffer
+        Scene::createLightingFrameBuffer();
+
         // Load default textures
         Material::createDefaultTextures();
     }
@@ -408,7 +1269,12 @@ Scene::Scene(const std::string &title, const int &width, const int &height, cons
 
 // Get the valid status
 bool Scene::isValid() {
-    return window != nullptr;
+    return (window != nullptr) && (!headless || (target_fbo != GL_FALSE));
+}
+
+// Get the headless status
+bool Scene::isHeadless() const {
+    return headless;
 }
 
 
@@ -436,37 +1302,37 @@ Camera *Scene::getActiveCamera() const {
 
 // Get camera by ID
 Camera *Scene::getCamera(const std::size_t &id) const {
-    std::map<std::size_t, Camera *>::const_iterator result = camera_stock.find(id);
+    SlotMap<Camera *>::const_iterator result = camera_stock.find(id);
     return result == camera_stock.end() ? nullptr : result->second;
 }
 
 // Get model by ID
 Model *Scene::getModel(const std::size_t &id) const {
-    std::map<std::size_t, std::pair<Model *, std::size_t> >::const_iterator result = model_stock.find(id);
+    SlotMap<std::pair<Model *, std::size_t> >::const_iterator result = model_stock.find(id);
     return result == model_stock.end() ? nullptr : result->second.first;
 }
 
 // Get light by ID
 Light *Scene::getLight(const std::size_t &id) const {
-    std::map<std::size_t, Light *>::const_iterator result = light_stock.find(id);
+    SlotMap<Light *>::const_iterator result = light_stock.find(id);
     return result == light_stock.end() ? nullptr : result->second;
 }
 
 // Get the program id of a model
 std::size_t Scene::getModelProgram(const std::size_t &id) const {
-    std::map<std::size_t, std::pair<Model *, std::size_t> >::const_iterator result = model_stock.find(id);
+    SlotMap<std::pair<Model *, std::size_t> >::const_iterator result = model_stock.find(id);
     return result == model_stock.end() ? 0U : result->second.second;
 }
 
 // Get program by ID
 GLSLProgram *Scene::getProgram(const std::size_t &id) const {
-    std::map<std::size_t, std::pair<GLSLProgram *, std::string> >::const_iterator result = program_stock.find(id);
+    SlotMap<std::pair<GLSLProgram *, std::string> >::const_iterator result = program_stock.find(id);
     return result == program_stock.end() ? nullptr : result->second.first;
 }
 
 // Get program description by ID
 std::string Scene::getProgramDescription(const std::size_t &id) const {
-    std::map<std::size_t, std::pair<GLSLProgram *, std::string> >::const_iterator result = program_stock.find(id);
+    SlotMap<std::pair<GLSLProgram *, std::string> >::const_iterator result = program_stock.find(id);
     return result == program_stock.end() ? "NOT_FOUND" : result->second.second;
 }
 
@@ -505,6 +1371,59 @@ double Scene::getFrames() const {
 }
 
 
+// Get the vertical synchronization status
+bool Scene::isVSyncEnabled() const {
+    return vsync;
+}
+
+// Get the last frame draw calls
+std::size_t Scene::getDrawCalls() const {
+    return draw_calls;
+}
+
+// Get the culling mode
+Scene::Culling Scene::getCulling() const {
+    return culling;
+}
+
+// Get the last frame occluded models
+std::size_t Scene::getOccludedModels() const {
+    return occluded_models;
+}
+
+// Get the last frame occluded objects inside the view frustum
+std::size_t Scene::getOccludedObjects() const {
+    return occluded_objects;
+}
+
+// Get the last frame fraction of the objects inside the view frustum hidden by occlusion
+float Scene::getOccludedFraction() const {
+    return occluded_fraction;
+}
+
+// Get the depth pre-pass status
+bool Scene::isDepthPrepassEnabled() const {
+    return depth_prepass;
+}
+
+// Get the fraction of the pre-pass objects fragments not shaded thanks to the depth pre-pass
+float Scene::getOverdrawSaved() const {
+    // The pre-pass counts the fragments the geometry pass would shade without it
+    const GLuint64 unsorted = prepass_counter->getSamples();
+    const GLuint64 shaded = geometry_counter->getSamples();
+    if (!depth_prepass || (unsorted == 0U) || (shaded > unsorted)) {
+        return 0.0F;
+    }
+
+    return 1.0F - static_cast<float>(shaded) / static_cast<float>(unsorted);
+}
+
+// Get the frame time governor
+Governor *Scene::getGovernor() {
+    return &governor;
+}
+
+
 // Setters
 
 // Set the background color
@@ -512,11 +1431,34 @@ void Scene::setBackgroundColor(const glm::vec3 &color) {
     background_color = color;
 }
 
+// Set the vertical synchronization status
+void Scene::setVSyncEnabled(const bool &status) {
+    vsync = status;
+    if (window != nullptr) {
+        glfwSwapInterval(vsync);
+    }
+}
+
+// Set the depth pre-pass status
+void Scene::setDepthPrepassEnabled(const bool &status) {
+    depth_prepass = status;
+    redraw = true;
+}
+
+// Set the culling mode
+void Scene::setCulling(const Scene::Culling &mode) {
+    culling = mode;
+    occluded_models = 0U;
+    occluded_objects = 0U;
+    occluded_fraction = 0.0F;
+    redraw = true;
+}
+
 
 // Select the active camara
 bool Scene::selectCamera(const std::size_t &id) {
     // Find camera
-    std::map<std::size_t, Camera *>::const_iterator result = camera_stock.find(id);
+    SlotMap<Camera *>::const_iterator result = camera_stock.find(id);
 
     // Return false if the camera does not exists
     if (result == camera_stock.end()) {
@@ -530,53 +1472,51 @@ bool Scene::selectCamera(const std::size_t &id) {
 
 // Add camera
 std::size_t Scene::addCamera(const bool &orthogonal) {
-    camera_stock[Scene::element_id] = new Camera(width, height, orthogonal);
-    return Scene::element_id++;
+    return camera_stock.insert(new Camera(width, height, orthogonal));
 }
 
 
 // Add empty model
 std::size_t Scene::addModel() {
-    model_stock[Scene::element_id] = std::pair<Model *, std::size_t>(new Model(), 0U);
-    return Scene::element_id++;
+    return model_stock.insert(std::pair<Model *, std::size_t>(new Model(), 0U));
 }
 
 // Add model
 std::size_t Scene::addModel(const std::string &path, const std::size_t &program_id) {
-    model_stock[Scene::element_id] = std::pair<Model *, std::size_t>(new Model(path), program_id);
-    return Scene::element_id++;
+    return model_stock.insert(std::pair<Model *, std::size_t>(new Model(path), program_id));
+}
+
+// Add model from a loader that has already read the path, must be called in the OpenGL thread
+std::size_t Scene::addModel(const std::string &path, ModelLoader *const loader, const std::size_t &program_id) {
+    return model_stock.insert(std::pair<Model *, std::size_t>(new Model(path, loader), program_id));
 }
 
 
 // Add light
 std::size_t Scene::addLight(const Light::Type &type) {
-    light_stock[Scene::element_id] = new Light(type);
-    return Scene::element_id++;
+    return light_stock.insert(new Light(type));
 }
 
 
 // Add empty GLSL program
 std::size_t Scene::addProgram(const std::string &desc) {
-    program_stock[Scene::element_id] = std::pair<GLSLProgram *, std::string>(new GLSLProgram(), desc);
-    return Scene::element_id++;
+    return program_stock.insert(std::pair<GLSLProgram *, std::string>(new GLSLProgram(), desc));
 }
 
 // Add GLSL program without geometry shader
 std::size_t Scene::addProgram(const std::string &desc, const std::string &vert, const std::string &frag) {
-    program_stock[Scene::element_id] = std::pair<GLSLProgram *, std::string>(new GLSLProgram(vert, frag), desc);
-    return Scene::element_id++;
+    return program_stock.insert(std::pair<GLSLProgram *, std::string>(new GLSLProgram(vert, frag), desc));
 }
 
 // Add GLSL program
 std::size_t Scene::addProgram(const std::string &desc, const std::string &vert, const std::string &geom, const std::string &frag) {
-    program_stock[Scene::element_id] = std::pair<GLSLProgram *, std::string>(new GLSLProgram(vert, geom, frag), desc);
-    return Scene::element_id++;
+    return program_stock.insert(std::pair<GLSLProgram *, std::string>(new GLSLProgram(vert, geom, frag), desc));
 }
 
 // Set program description
 bool Scene::setProgramDescription(const std::string &desc, const std::size_t &id) {
     // Find the program
-    std::map<std::size_t, std::pair<GLSLProgram *, std::string> >::iterator result = program_stock.find(id);
+    SlotMap<std::pair<GLSLProgram *, std::string> >::iterator result = program_stock.find(id);
 
     // Return false if the program does not exists
     if (result == program_stock.end()) {
@@ -599,6 +1539,7 @@ void Scene::setLightingPassProgram(const std::size_t &id) {
 void Scene::setDefaultGeometryPassProgram(const std::string &desc, const std::string &vert, const std::string &frag) {
     program_stock[0U].first->link(vert, frag);
     program_stock[0U].second = desc + " (Default geometry pass)";
+    redraw = true;
 }
 
 // Se the default geometry pass program description
@@ -611,6 +1552,7 @@ void Scene::setDefaultGeometryPassProgramDescription(const std::string &desc) {
 void Scene::setDefaultLightingPassProgram(const std::string &desc, const std::string &vert, const std::string &frag) {
     program_stock[1U].first->link(vert, frag);
     program_stock[1U].second = desc + " (Default lighting pass)";
+    redraw = true;
 }
 
 // Se the default lighing pass program description
@@ -619,6 +1561,13 @@ void Scene::setDefaultLightingPassProgramDescription(const std::string &desc) {
 }
 
 
+// Set the depth only program of the occlusion queries and the depth pre-pass
+void Scene::setDepthProgram(const std::string &vert, const std::string &frag) {
+    depth_program->link(vert, frag);
+    redraw = true;
+}
+
+
 // Set title
 void Scene::setTitle(const std::string &new_title) {
     title = new_title;
@@ -628,7 +1577,7 @@ void Scene::setTitle(const std::string &new_title) {
 // Set program to model
 std::size_t Scene::setProgramToModel(const std::size_t &program_id, const std::size_t &model_id) {
     // Search the model
-    std::map<std::size_t, std::pair<Model *, std::size_t> >::iterator result = model_stock.find(model_id);
+    SlotMap<std::pair<Model *, std::size_t> >::iterator result = model_stock.find(model_id);
 
     // Return zero if the model does not exists
     if (result ==  model_stock.end()) {
@@ -642,6 +1591,12 @@ std::size_t Scene::setProgramToModel(const std::size_t &program_id, const std::s
     // Set the program ID to the model
     result->second.second = program_id;
 
+    // Generate the model tangents if the program reads them
+    const SlotMap<std::pair<GLSLProgram *, std::string> >::iterator program = program_stock.find(program_id);
+    if ((program != program_stock.end()) && program->second.first->isAttributeActive("l_tangent")) {
+        result->second.first->loadTangents();
+    }
+
     // Return the previous program ID
     return previous_program;
 }
@@ -667,26 +1622,76 @@ void Scene::mainLoop() {
         std::cerr << "warning: the default lighting pass program has not been set or is not valid" << std::endl;
     }
 
+    // Headless scenes have no window to close
+    if (headless) {
+        std::cerr << "error: the headless scenes have no main loop, use renderFrame instead" << std::endl;
+        return;
+    }
+
     // The rendering main loop
     while (glfwWindowShouldClose(window) == GLFW_FALSE) {
-        // Draw the scene
-        drawScene();
+        // Render the frame only if the scene has changed
+        if (updateStateSignature()) {
+            renderFrame();
+
+            // Poll events and swap buffers
+            glfwPollEvents();
+            glfwSwapBuffers(window);
+        }
+
+        // Block until an event arrives while idle
+        else {
+            glfwWaitEventsTimeout(Scene::IDLE_TIMEOUT);
+        }
+    }
+}
+
+// Render a single frame into the target frame buffer without polling events
+void Scene::renderFrame() {
+    // Mark the frame for the profiler
+    Profiler::markFrame();
+
+    // Draw the scene and update the frame timing
+    const double frame_start = glfwGetTime();
+    drawScene();
+    updateFrameTiming(glfwGetTime() - frame_start);
 
-        // Poll events and swap buffers
-        glfwPollEvents();
-        glfwSwapBuffers(window);
+    // Count frame
+    kframes += 0.001;
+}
 
-        // Count frame
-        kframes += 0.001;
+// Read the target frame buffer as RGBA rows from bottom to top
+bool Scene::readPixels(std::vector<unsigned char> &pixels) const {
+    // Check the window status
+    if (window == nullptr) {
+        std::cerr << "error: there is no window" << std::endl;
+        return false;
     }
+
+    // Read the pixels of the last frame
+    pixels.resize(static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4U);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, target_fbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, GL_FALSE);
+
+    return true;
+}
+
+// Redraw the scene in the next frame of the main loop
+void Scene::invalidate() {
+    redraw = true;
 }
 
 
 // Reload all programs
 void Scene::reloadPrograms() {
-    for (std::pair<const std::size_t, std::pair<GLSLProgram *, std::string> > &program_data : program_stock) {
+    for (std::pair<std::size_t, std::pair<GLSLProgram *, std::string> > &program_data : program_stock) {
         program_data.second.first->link();
     }
+
+    // The shaders may have changed
+    redraw = true;
 }
 
 
@@ -699,7 +1704,7 @@ bool Scene::removeCamera(const std::size_t &id) {
     }
 
     // Find the camera
-    std::map<std::size_t, Camera *>::const_iterator result = camera_stock.find(id);
+    SlotMap<Camera *>::const_iterator result = camera_stock.find(id);
 
     // Return false if the camera does not exists
     if (result == camera_stock.end()) {
@@ -708,12 +1713,12 @@ bool Scene::removeCamera(const std::size_t &id) {
 
     // Update the current camera if is selected to delete
     if (result->second == active_camera) {
-        active_camera = std::next(result, result->second == camera_stock.rbegin()->second ? -1 : 1)->second;
+        active_camera = (result + 1 == camera_stock.end() ? result - 1 : result + 1)->second;
     }
 
     // Delete camera
     delete result->second;
-    camera_stock.erase(result);
+    camera_stock.erase(id);
 
     return true;
 }
@@ -721,16 +1726,19 @@ bool Scene::removeCamera(const std::size_t &id) {
 // Remove camera
 bool Scene::removeModel(const std::size_t &id) {
     // Search the model
-    std::map<std::size_t, std::pair<Model *, std::size_t> >::const_iterator result = model_stock.find(id);
+    SlotMap<std::pair<Model *, std::size_t> >::const_iterator result = model_stock.find(id);
 
     // Return false if the model does not exists
     if (result == model_stock.end()) {
         return false;
     }
 
-    // Delete the model
+    // Delete the model and its occlusion queries
+    if (query_culler != nullptr) {
+        query_culler->remove(result->second.first);
+    }
     delete result->second.first;
-    model_stock.erase(result);
+    model_stock.erase(id);
 
     return true;
 }
@@ -744,7 +1752,7 @@ bool Scene::removeLight(const std::size_t &id) {
     }
 
     // Search the light
-    std::map<std::size_t, Light *>::const_iterator result = light_stock.find(id);
+    SlotMap<Light *>::const_iterator result = light_stock.find(id);
 
     // Return false if the light does not exists
     if (result == light_stock.end()) {
@@ -753,7 +1761,14 @@ bool Scene::removeLight(const std::size_t &id) {
 
     // Delete the light
     delete result->second;
-    light_stock.erase(result);
+    light_stock.erase(id);
+
+    // Delete its GPU timer
+    std::map<std::size_t, GPUTimer *>::iterator timer = light_timer.find(id);
+    if (timer != light_timer.end()) {
+        delete timer->second;
+        light_timer.erase(timer);
+    }
 
     return true;
 }
@@ -767,7 +1782,7 @@ bool Scene::removeProgram(const std::size_t &id) {
     }
 
     // Search the program
-    std::map<std::size_t, std::pair<GLSLProgram *, std::string> >::const_iterator result = program_stock.find(id);
+    SlotMap<std::pair<GLSLProgram *, std::string> >::const_iterator result = program_stock.find(id);
 
     // Return false if the program does not exists
     if (result == program_stock.end()) {
@@ -776,7 +1791,8 @@ bool Scene::removeProgram(const std::size_t &id) {
 
     // Delete the program
     delete result->second.first;
-    program_stock.erase(result);
+    program_stock.erase(id);
+    redraw = true;
 
     return true;
 }
@@ -793,6 +1809,7 @@ void Scene::removeDefaultGeometryPassProgram() {
     // Create a empty program
     program_data.first =  new GLSLProgram();
     program_data.second = "Empty (Default geometry pass)";
+    redraw = true;
 }
 
 // Remove the default lighting pass program
@@ -806,6 +1823,7 @@ void Scene::removeDefaultLightingPassProgram() {
     // Create a empty program
     program_data.first =  new GLSLProgram();
     program_data.second = "Empty (Default lighting pass)";
+    redraw = true;
 }
 
 
@@ -814,19 +1832,39 @@ void Scene::removeDefaultLightingPassProgram() {
 // Scene destructor
 Scene::~Scene() {
     // Delete cameras
-    for (const std::pair<const std::size_t, const Camera *const> &camera_data : camera_stock) {
+    for (const std::pair<std::size_t, Camera *> &camera_data : camera_stock) {
         delete camera_data.second;
     }
 
     // Delete models
-    for (const std::pair<const std::size_t, std::pair<const Model *const, std::size_t> > &model_data : model_stock) {
+    for (const std::pair<std::size_t, std::pair<Model *, std::size_t> > &model_data : model_stock) {
         delete model_data.second.first;
     }
 
     // Delete programs
-    for (const std::pair<const std::size_t, std::pair<const GLSLProgram *const , const std::string> > &program_data : program_stock) {
+    for (const std::pair<std::size_t, std::pair<GLSLProgram *, std::string> > &program_data : program_stock) {
         delete program_data.second.first;
     }
+    delete depth_program;
+
+    // Delete the target frame buffer while the context exists
+    if (target_fbo != GL_FALSE) {
+        glDeleteRenderbuffers(1, &target_rbo);
+        glDeleteFramebuffers(1, &target_fbo);
+    }
+
+    // Delete the GPU timers while the context exists
+    delete geometry_timer;
+    delete background_timer;
+    delete composite_timer;
+    for (const std::pair<const std::size_t, GPUTimer *> &timer_data : light_timer) {
+        delete timer_data.second;
+    }
+
+    // Delete the occlusion queries and fragments counters while the context exists
+    delete query_culler;
+    delete prepass_counter;
+    delete geometry_counter;
 
     // Destroy window
     if (window != nullptr) {
@@ -835,9 +1873,14 @@ Scene::~Scene() {
 
     // If is the last instance
     if ((Scene::instances == 1U) && Scene::initialized_glad) {
+        // Delete the lighting frame buffer
+        glDeleteRenderbuffers(1, &Scene::lighting_rbo);
+        glDeleteTextures(1, &Scene::lighting_texture);
+        glDeleteFramebuffers(1, &Scene::lighting_fbo);
+
         // Delete the geometry frame buffer
         glDeleteTextures(TEXTURE_BUFFERS, Scene::buffer_texture);
-        glDeleteRenderbuffers(1, &Scene::rbo);
+        glDeleteTextures(1, &Scene::depth_texture);
         glDeleteFramebuffers(1, &Scene::fbo);
 
         // Delete the square vertex buffer object and vertex array object
@@ -885,4 +1928,37 @@ const GLubyte *Scene::getOpenGLVersion() {
 // Get the GLSL version
 const GLubyte *Scene::getGLSLVersion() {
     return Scene::glsl_version;
+}
+
+
+// Get the geometry buffer layout
+Scene::Layout Scene::getGeometryBufferLayout() {
+    return Scene::geometry_buffer_layout;
+}
+
+// Get the render scale
+float Scene::getRenderScale() {
+    return Scene::render_scale;
+}
+
+
+// Static setters
+
+// Set the geometry buffer layout
+void Scene::setGeometryBufferLayout(const Scene::Layout &layout) {
+    // Nothing to do for the same layout
+    if (layout == Scene::geometry_buffer_layout) {
+        return;
+    }
+
+    // Reallocate the texture buffers if the geometry frame buffer exists
+    Scene::geometry_buffer_layout = layout;
+    if (Scene::fbo != GL_FALSE) {
+        Scene::setupGeometryFrameBuffer(Scene::buffer_texture_mask);
+    }
+}
+
+// Set the render scale
+void Scene::setRenderScale(const float &scale) {
+    Scene::render_scale = glm::clamp(scale, 0.25F, 2.0F);
 }
\ No newline at end of file
@@ -5,20 +5,80 @@
 #include "../model/model.hpp"
 #include "light.hpp"
 #include "glslprogram.hpp"
+#include "gputimer.hpp"
+#include "governor.hpp"
+#include "framestats.hpp"
+#include "slotmap.hpp"
+#include "occlusionculler.hpp"
+#include "queryculler.hpp"
+#include "fragmentcounter.hpp"
 
 #include "../glad/glad.h"
 #include <GLFW/glfw3.h>
 
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
 #include <glm/vec3.hpp>
 
 #include <string>
+#include <cstdint>
 
 #include <map>
+#include <vector>
 #include <forward_list>
 
 
 class Scene {
+    public:
+        // Enumerations
+
+        /** Geometry buffer layouts */
+        enum Layout {
+            /** Full precision position, normal and metadata */
+            STANDARD,
+
+            /** Position reconstructed from depth, octahedral normal and 8-bit metadata */
+            COMPACT
+        };
+
+        /** Culling modes of the draw list */
+        enum Culling {
+            /** View frustum culling only */
+            FRUSTUM_CULLING,
+
+            /** Software depth buffer of the largest models */
+            SOFTWARE_OCCLUSION,
+
+            /** Hardware occlusion queries reusing the previous frame visibility */
+            HARDWARE_OCCLUSION
+        };
+
+
     protected:
+        // Structs
+
+        /** Visible model draw of the sorted draw list */
+        struct Draw {
+            /** Model */
+            Model *model;
+
+            /** Geometry pass program */
+            GLSLProgram *program;
+
+            /** View depth of the bounding box center */
+            float depth;
+
+            /** Normalized device area of the bounding box, infinite if it crosses the near plane */
+            float area;
+
+            /** First object visible status index */
+            std::size_t first_object;
+
+            /** Objects left out of the depth pre-pass status */
+            bool late;
+        };
+
+
         // Attributes
 
         /** Window */
@@ -34,6 +94,16 @@ class Scene {
         int height;
 
 
+        /** Headless status */
+        bool headless;
+
+        /** Target frame buffer object, the default frame buffer if not headless */
+        GLuint target_fbo;
+
+        /** Target frame buffer color render buffer */
+        GLuint target_rbo;
+
+
         /** Background color */
         glm::vec3 background_color;
 
@@ -43,27 +113,104 @@ class Scene {
 
 
         /** Camera stock */
-        std::map<std::size_t, Camera *> camera_stock;
+        SlotMap<Camera *> camera_stock;
 
         /** Model stock */
-        std::map<std::size_t, std::pair<Model *, std::size_t> > model_stock;
+        SlotMap<std::pair<Model *, std::size_t> > model_stock;
 
 
         /** Light stock */
-        std::map<std::size_t, Light *> light_stock;
+        SlotMap<Light *> light_stock;
 
 
         /** Lighting pass program ID */
         std::size_t lighting_program;
 
         /** Program stock */
-        std::map<std::size_t, std::pair<GLSLProgram *, std::string> > program_stock;
+        SlotMap<std::pair<GLSLProgram *, std::string> > program_stock;
 
 
         /** Thousands of frames */
         double kframes;
 
 
+        /** Last frame draw calls */
+        std::size_t draw_calls;
+
+        /** Last frame visible models sorted by program and depth */
+        std::vector<Scene::Draw> draw_list;
+
+        /** Vertical synchronization status */
+        bool vsync;
+
+
+        /** Culling mode of the draw list */
+        Scene::Culling culling;
+
+        /** Software occlusion culler */
+        OcclusionCuller occlusion_culler;
+
+        /** Hardware occlusion queries culler */
+        QueryCuller *query_culler;
+
+        /** Depth only program of the occlusion queries */
+        GLSLProgram *depth_program;
+
+        /** Last frame visible status of the objects of the draw list */
+        std::vector<unsigned char> object_visible;
+
+        /** Last frame occluded models */
+        std::size_t occluded_models;
+
+        /** Last frame occluded objects inside the view frustum */
+        std::size_t occluded_objects;
+
+        /** Last frame fraction of the objects inside the view frustum hidden by occlusion */
+        float occluded_fraction;
+
+
+        /** Depth pre-pass status */
+        bool depth_prepass;
+
+        /** Last frame objects of the draw list drawn in the depth pre-pass */
+        std::vector<unsigned char> object_prepass;
+
+        /** Last frame objects of the draw list that may discard fragments, drawn after the pre-pass */
+        std::vector<unsigned char> object_late;
+
+        /** Depth pre-pass fragments counter */
+        FragmentCounter *prepass_counter;
+
+        /** Geometry pass fragments counter */
+        FragmentCounter *geometry_counter;
+
+
+        /** Geometry pass GPU timer */
+        GPUTimer *geometry_timer;
+
+        /** Background clear GPU timer */
+        GPUTimer *background_timer;
+
+        /** Composite pass GPU timer */
+        GPUTimer *composite_timer;
+
+        /** Lights GPU timers */
+        std::map<std::size_t, GPUTimer *> light_timer;
+
+        /** Frame time governor */
+        Governor governor;
+
+        /** Frame times statistics */
+        FrameStats frame_stats;
+
+
+        /** Redraw the scene in the next frame even if its state signature has not changed */
+        bool redraw;
+
+        /** State signature of the last drawn scene */
+        std::uint64_t state_signature;
+
+
         // Constructors
 
         /** Disable the default constructor */
@@ -81,24 +228,67 @@ class Scene {
         /** Draw the scene */
         void drawScene();
 
+        /** Copy and upscale the last lighting image to the target frame buffer */
+        void compositeScene();
+
+        /** Build the sorted draw list of the models inside the view frustum */
+        void buildDrawList();
+
+        /** Cull the models and objects of the draw list hidden by the largest models */
+        void cullOccludedModels(const glm::mat4 &view_projection);
+
+        /** Collect the previous frame occlusion queries of the draw list */
+        void collectOcclusionQueries(const glm::mat4 &view_projection);
+
+        /** Query the bounding boxes of the draw list and draw the hidden objects whose boxes pass */
+        void drawOcclusionQueries();
+
+        /** Split the visible objects of the draw list between the depth pre-pass and the late draws */
+        void splitDepthPrepass();
+
+        /** Update the scene state signature, true if the scene has to be redrawn */
+        bool updateStateSignature();
+
+        /** Get the scissor rectangle of a light, false if the light is out of view */
+        bool getLightScissor(const Light *const light, glm::ivec4 &rect) const;
+
+        /** Get the last frame GPU time in milliseconds */
+        virtual double getGPUFrameTime() const;
+
+        /** Record the frame times and update the governor with the frame CPU time in seconds */
+        void updateFrameTiming(const double &cpu_time);
+
+
+        /** Create the offscreen target frame buffer */
+        bool createTargetFrameBuffer();
+
+
+        // Static const attributes
+
+        /** Events wait timeout in seconds of the idle main loops */
+        static const double IDLE_TIMEOUT;
+
+        /** Maximum models rendered as occluders per frame */
+        static const std::size_t MAX_OCCLUDERS = 16U;
+
 
         // Static attributes
 
         /** Instances counter */
         static std::size_t instances;
 
-        /** Elements unique ID's */
-        static std::size_t element_id;
-
         /** Glad loaded flag */
         static bool initialized_glad;
 
 
-        /** Screen width */
-        static GLsizei screen_width;
+        /** Frame buffers width */
+        static GLsizei buffer_width;
+
+        /** Frame buffers height */
+        static GLsizei buffer_height;
 
-        /** Screen height */
-        static GLsizei screen_height;
+        /** Render scale relative to the window resolution */
+        static float render_scale;
 
 
         /** Square vertex array object */
@@ -111,12 +301,31 @@ class Scene {
         /** Geometry frame buffer object */
         static GLuint fbo;
 
-        /** Render buffer object */
-        static GLuint rbo;
+        /** Depth and stencil texture */
+        static GLuint depth_texture;
 
         /** Buffer textures */
         static GLuint buffer_texture[];
 
+        /** Buffer textures sampler names */
+        static const GLchar *const buffer_texture_name[];
+
+        /** Buffer textures requested by the lighting program */
+        static GLuint buffer_texture_mask;
+
+        /** Geometry buffer layout */
+        static Scene::Layout geometry_buffer_layout;
+
+
+        /** Lighting frame buffer object */
+        static GLuint lighting_fbo;
+
+        /** Lighting texture */
+        static GLuint lighting_texture;
+
+        /** Lighting depth and stencil render buffer, a copy of the geometry stencil */
+        static GLuint lighting_rbo;
+
 
         /** OpenGL vendor */
         static const GLubyte *opengl_vendor;
@@ -136,9 +345,25 @@ class Scene {
         /** Create the geometry frame buffer */
         static void createGeometryFrameBuffer();
 
+        /** Allocate and attach the buffer textures of the given mask with the current layout */
+        static void setupGeometryFrameBuffer(const GLuint &mask);
+
         /** Create and attach texture to the frame buffer object */
         static void attachTextureToFrameBuffer(const GLenum &attachment, const GLint &internalFormat, const GLenum &format, const GLenum &type);
 
+        /** Detach and release a texture of the frame buffer object */
+        static void detachTextureFromFrameBuffer(const GLenum &attachment);
+
+        /** Resize the geometry and lighting frame buffers */
+        static void resizeFrameBuffers(const GLsizei &width, const GLsizei &height);
+
+        /** Get a window size scaled by the render scale */
+        static GLsizei getScaledSize(const int &size);
+
+
+        /** Create the lighting frame buffer */
+        static void createLightingFrameBuffer();
+
 
         /** Create a square fitted to the screen */
         static void createSquare();
@@ -150,12 +375,22 @@ class Scene {
         /** GLFW framebuffer size callback */
         static void framebufferSizeCallback(GLFWwindow *window, int width, int height);
 
+        /** GLFW window refresh callback */
+        static void windowRefreshCallback(GLFWwindow *window);
+
+
+        /** Combine raw data into a state signature */
+        static void sign(std::uint64_t &signature, const void *const data, const std::size_t &size);
+
+        /** Combine the parameters and textures of a material into a state signature */
+        static void signMaterial(std::uint64_t &signature, const Material *const material);
+
 
     public:
         // Constructor
 
         /** Scene constructor */
-        Scene(const std::string &title, const int &width = 800, const int &height = 600, const int &context_ver_maj = 3, const int &context_ver_min = 3);
+        Scene(const std::string &title, const int &width = 800, const int &height = 600, const int &context_ver_maj = 3, const int &context_ver_min = 3, const bool &headless = false);
 
 
         // Getters
@@ -163,6 +398,9 @@ class Scene {
         /** Get the valid status */
         bool isValid();
 
+        /** Get the headless status */
+        bool isHeadless() const;
+
 
         /** Get resolution */
         std::string getTitle() const;
@@ -219,11 +457,48 @@ class Scene {
         double getFrames() const;
 
 
+        /** Get the vertical synchronization status */
+        bool isVSyncEnabled() const;
+
+        /** Get the last frame draw calls */
+        std::size_t getDrawCalls() const;
+
+        /** Get the culling mode */
+        Scene::Culling getCulling() const;
+
+        /** Get the last frame occluded models */
+        std::size_t getOccludedModels() const;
+
+        /** Get the last frame occluded objects inside the view frustum */
+        std::size_t getOccludedObjects() const;
+
+        /** Get the last frame fraction of the objects inside the view frustum hidden by occlusion */
+        float getOccludedFraction() const;
+
+        /** Get the depth pre-pass status */
+        bool isDepthPrepassEnabled() const;
+
+        /** Get the fraction of the pre-pass objects fragments not shaded thanks to the depth pre-pass */
+        float getOverdrawSaved() const;
+
+        /** Get the frame time governor */
+        Governor *getGovernor();
+
+
         // Setters
 
         /** Set the background color */
         void setBackgroundColor(const glm::vec3 &color);
 
+        /** Set the vertical synchronization status */
+        void setVSyncEnabled(const bool &status);
+
+        /** Set the culling mode */
+        void setCulling(const Scene::Culling &mode);
+
+        /** Set the depth pre-pass status */
+        void setDepthPrepassEnabled(const bool &status);
+
 
         /** Select the active camara */
         bool selectCamera(const std::size_t &id);
@@ -238,6 +513,9 @@ class Scene {
         /** Add model */
         std::size_t addModel(const std::string &path, const std::size_t &program_id = 0U);
 
+        /** Add model from a loader that has already read the path, must be called in the OpenGL thread */
+        std::size_t addModel(const std::string &path, ModelLoader *const loader, const std::size_t &program_id = 0U);
+
 
         /** Add light */
         std::size_t addLight(const Light::Type &type = Light::DIRECTIONAL);
@@ -274,6 +552,10 @@ class Scene {
         void setDefaultLightingPassProgramDescription(const std::string &desc);
 
 
+        /** Set the depth only program of the occlusion queries and the depth pre-pass */
+        void setDepthProgram(const std::string &vert, const std::string &frag);
+
+
         /** Set title */
         void setTitle(const std::string &new_title);
 
@@ -286,6 +568,15 @@ class Scene {
         /** Render main loop */
         virtual void mainLoop();
 
+        /** Render a single frame into the target frame buffer without polling events */
+        void renderFrame();
+
+        /** Read the target frame buffer as RGBA rows from bottom to top */
+        bool readPixels(std::vector<unsigned char> &pixels) const;
+
+        /** Redraw the scene in the next frame of the main loop */
+        void invalidate();
+
 
         /** Reload all programs */
         void reloadPrograms();
@@ -330,6 +621,22 @@ class Scene {
 
         /** Get the GLSL version */
         static const GLubyte *getGLSLVersion();
+
+
+        /** Get the geometry buffer layout */
+        static Scene::Layout getGeometryBufferLayout();
+
+        /** Get the render scale */
+        static float getRenderScale();
+
+
+        // Static setters
+
+        /** Set the geometry buffer layout */
+        static void setGeometryBufferLayout(const Scene::Layout &layout);
+
+        /** Set the render scale, clamped between 0.25 and 2.0 */
+        static void setRenderScale(const float &scale);
 };
 
 #endif // __SCENE_HPP_
\ No newline at end of file
@@ -0,0 +1,197 @@
+#ifndef __SLOT_MAP_HPP_
+#define __SLOT_MAP_HPP_
+
+#include <cstddef>
+#include <utility>
+
+#include <vector>
+
+
+/** Generational slot map with the elements packed in a contiguous array */
+template <typename T>
+class SlotMap {
+    public:
+        // Types
+
+        /** Packed element with its ID */
+        typedef std::pair<std::size_t, T> Element;
+
+        /** Packed elements iterator */
+        typedef typename std::vector<Element>::iterator iterator;
+
+        /** Packed elements constant iterator */
+        typedef typename std::vector<Element>::const_iterator const_iterator;
+
+
+    private:
+        // Structs
+
+        /** Slot of the indirection table */
+        struct Slot {
+            /** Index in the packed elements, or next free slot if unused */
+            std::size_t index;
+
+            /** Generation increased on each removal */
+            std::size_t generation;
+        };
+
+
+        // Attributes
+
+        /** Packed elements in insertion order */
+        std::vector<Element> element;
+
+        /** Indirection table from the slot to the packed elements */
+        std::vector<SlotMap::Slot> slot;
+
+        /** First free slot, the slots size if there is none */
+        std::size_t free_slot;
+
+
+        // Static const attributes
+
+        /** Bits of the slot in the ID, the rest are the generation */
+        static const std::size_t SLOT_BITS = sizeof(std::size_t) * 4U;
+
+        /** Slot mask of the ID */
+        static const std::size_t SLOT_MASK = (static_cast<std::size_t>(1U) << SlotMap::SLOT_BITS) - 1U;
+
+
+        // Methods
+
+        /** Get the packed index of an ID, the packed size if it is not valid */
+        std::size_t getIndex(const std::size_t &id) const {
+            const std::size_t slot_index = id & SlotMap::SLOT_MASK;
+            if ((slot_index >= slot.size()) || (slot[slot_index].generation != (id >> SlotMap::SLOT_BITS)) || (slot[slot_index].index >= element.size()) || (element[slot[slot_index].index].first != id)) {
+                return element.size();
+            }
+
+            return slot[slot_index].index;
+        }
+
+
+    public:
+        // Constructor
+
+        /** Empty slot map constructor, the slots before the first one are never used so their IDs are always invalid */
+        explicit SlotMap(const std::size_t &first_slot = 1U) :
+            free_slot(first_slot) {
+            // Reserve the unused slots
+            SlotMap::Slot unused;
+            unused.index = static_cast<std::size_t>(-1);
+            unused.generation = 0U;
+            slot.assign(first_slot, unused);
+        }
+
+
+        // Getters
+
+        /** Get the number of elements */
+        std::size_t size() const {
+            return element.size();
+        }
+
+        /** Get the empty status */
+        bool empty() const {
+            return element.empty();
+        }
+
+        /** Get the valid status of an ID */
+        bool contains(const std::size_t &id) const {
+            return getIndex(id) != element.size();
+        }
+
+
+        /** Find an element by ID, the end iterator if it does not exists */
+        iterator find(const std::size_t &id) {
+            return element.begin() + static_cast<std::ptrdiff_t>(getIndex(id));
+        }
+
+        /** Find an element by ID, the end iterator if it does not exists */
+        const_iterator find(const std::size_t &id) const {
+            return element.begin() + static_cast<std::ptrdiff_t>(getIndex(id));
+        }
+
+        /** Get an element by a valid ID */
+        T &operator[](const std::size_t &id) {
+            return element[getIndex(id)].second;
+        }
+
+
+        /** Get the first element iterator */
+        iterator begin() {
+            return element.begin();
+        }
+
+        /** Get the first element iterator */
+        const_iterator begin() const {
+            return element.begin();
+        }
+
+        /** Get the past the last element iterator */
+        iterator end() {
+            return element.end();
+        }
+
+        /** Get the past the last element iterator */
+        const_iterator end() const {
+            return element.end();
+        }
+
+
+        // Methods
+
+        /** Insert an element and get its ID */
+        std::size_t insert(const T &value) {
+            // Add a new slot if there are no free slots
+            if (free_slot == slot.size()) {
+                SlotMap::Slot new_slot;
+                new_slot.index = slot.size() + 1U;
+                new_slot.generation = 0U;
+                slot.push_back(new_slot);
+            }
+
+            // Take the free slot
+            const std::size_t slot_index = free_slot;
+            SlotMap::Slot &taken = slot[slot_index];
+            free_slot = taken.index;
+            taken.index = element.size();
+
+            // Pack the element with its ID
+            const std::size_t id = (taken.generation << SlotMap::SLOT_BITS) | slot_index;
+            element.push_back(Element(id, value));
+            return id;
+        }
+
+        /** Remove an element by ID, keeping the order of the rest, false if it does not exists */
+        bool erase(const std::size_t &id) {
+            // Find the element
+            const std::size_t index = getIndex(id);
+            if (index == element.size()) {
+                return false;
+            }
+
+            // Remove the element and shift the slots of the following elements
+            element.erase(element.begin() + static_cast<std::ptrdiff_t>(index));
+            for (std::size_t i = index; i < element.size(); i++) {
+                slot[element[i].first & SlotMap::SLOT_MASK].index = i;
+            }
+
+            // Invalidate the ID and release the slot
+            const std::size_t slot_index = id & SlotMap::SLOT_MASK;
+            slot[slot_index].generation = (slot[slot_index].generation + 1U) & SlotMap::SLOT_MASK;
+            slot[slot_index].index = free_slot;
+            free_slot = slot_index;
+
+            return true;
+        }
+
+        /** Remove all elements */
+        void clear() {
+            while (!element.empty()) {
+                erase(element.back().first);
+            }
+        }
+};
+
+#endif // __SLOT_MAP_HPP_
\ No newline at end of file
@@ -0,0 +1,286 @@
+#include "thumbnailscene.hpp"
+
+#include "pngwriter.hpp"
+
+#include "../profiler/profiler.hpp"
+#include "../dirsep.h"
+
+#include <glm/geometric.hpp>
+#include <glm/trigonometric.hpp>
+
+#include <algorithm>
+#include <thread>
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+#ifndef _WIN32
+#include <dirent.h>
+#endif
+
+
+// Static const attributes
+
+// Number of canonical views
+const int ThumbnailScene::VIEWS;
+
+// Canonical views directions from the model
+const glm::vec3 ThumbnailScene::VIEW_DIRECTION[] = {
+    glm::vec3( 0.0F, 0.0F,  1.0F),
+    glm::vec3( 1.0F, 0.6F,  1.0F),
+    glm::vec3( 1.0F, 0.0F,  0.0F),
+    glm::vec3( 0.0F, 0.0F, -1.0F),
+    glm::vec3(-1.0F, 0.0F,  0.0F),
+    glm::vec3( 0.0F, 1.0F,  0.2F)
+};
+
+// Canonical views names
+const char *const ThumbnailScene::VIEW_NAME[] = {
+    "front",
+    "iso",
+    "right",
+    "back",
+    "left",
+    "top"
+};
+
+
+// Private methods
+
+// Read the models in a worker thread and queue them
+void ThumbnailScene::readModels(const std::vector<std::string> &path, std::atomic<std::size_t> *const next) {
+    // Queue capacity to bound the memory of the read models
+    const std::size_t capacity = static_cast<std::size_t>(threads) * 2U;
+
+    for (std::size_t index = (*next)++; index < path.size(); index = (*next)++) {
+        // Read without OpenGL calls
+        ThumbnailScene::Job job;
+        job.index  = index;
+        job.loader = ModelLoader::read(path[index], ModelLoader::OBJ);
+
+        // Wait for space and queue the read model
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        queue_space.wait(lock, [this, &capacity] () { return queue.size() < capacity; });
+        queue.push_back(job);
+        queue_ready.notify_one();
+    }
+}
+
+// Render the views of a read model, false if it could not be loaded
+bool ThumbnailScene::renderModel(const std::string &path, ModelLoader *const loader, const std::string &output_dir) {
+    PROFILE_ZONE("ThumbnailScene::renderModel");
+
+    // Unknown format
+    if (loader == nullptr) {
+        return false;
+    }
+
+    // Upload the model, the origin matrix fits it into the unit cube
+    const std::size_t id = addModel(path, loader, model_program);
+    if (!getModel(id)->isOpen()) {
+        removeModel(id);
+        return false;
+    }
+
+    // Distance to fit the bounding sphere of the unit cube in the narrowest field of view
+    const float fov = glm::radians(active_camera->getFOV());
+    const float aspect = static_cast<float>(width) / static_cast<float>(height);
+    const float narrowest = std::min(fov, 2.0F * std::atan(std::tan(fov / 2.0F) * aspect));
+    const float distance = 0.8660254F / std::sin(narrowest / 2.0F);
+
+    // Render and write each view
+    const std::string name = output_dir + DIR_SEP + ThumbnailScene::getOutputName(path);
+    std::vector<unsigned char> pixels;
+    bool status = true;
+    for (int i = 0; i < views; i++) {
+        // Place the camera and the first light as a headlight
+        const glm::vec3 direction = glm::normalize(ThumbnailScene::VIEW_DIRECTION[i]);
+        active_camera->setPosition(direction * distance);
+        active_camera->setDirection(-direction);
+        if (!light_stock.empty()) {
+            light_stock.begin()->second->setDirection(direction);
+        }
+
+        // Render and read back the frame
+        renderFrame();
+        status = readPixels(pixels) && PNGWriter::write(name + "_" + ThumbnailScene::VIEW_NAME[i] + ".png", width, height, pixels) && status;
+    }
+
+    // Free the model
+    removeModel(id);
+    return status;
+}
+
+
+// Private static methods
+
+// List the OBJ files of a directory tree
+bool ThumbnailScene::listDirectory(const std::string &path, std::vector<std::string> &list) {
+#ifndef _WIN32
+    // Open the directory
+    DIR *directory = opendir(path.c_str());
+    if (directory == nullptr) {
+        return false;
+    }
+
+    // Add the OBJ files and walk the subdirectories
+    for (struct dirent *entry = readdir(directory); entry != nullptr; entry = readdir(directory)) {
+        const std::string name = entry->d_name;
+        if ((name == ".") || (name == "..")) {
+            continue;
+        }
+
+        const std::string entry_path = path + DIR_SEP + name;
+        if (!ThumbnailScene::listDirectory(entry_path, list) && (name.size() > 4U) && (name.compare(name.size() - 4U, 4U, ".obj") == 0)) {
+            list.push_back(entry_path);
+        }
+    }
+
+    closedir(directory);
+    return true;
+#else
+    static_cast<void>(path);
+    static_cast<void>(list);
+    return false;
+#endif
+}
+
+// Get the output base name of a model path
+std::string ThumbnailScene::getOutputName(const std::string &path) {
+    // Remove the extension and the leading relative components
+    std::string name = path.substr(0U, path.find_last_of('.'));
+    const std::size_t begin = name.find_first_not_of("./\\");
+    name = begin == std::string::npos ? "model" : name.substr(begin);
+
+    // Flatten the directories to keep the names unique
+    std::replace(name.begin(), name.end(), '/', '_');
+    std::replace(name.begin(), name.end(), '\\', '_');
+    std::replace(name.begin(), name.end(), ':', '_');
+    return name;
+}
+
+
+// Constructor
+
+// Thumbnail scene constructor
+ThumbnailScene::ThumbnailScene(const int &width, const int &height) :
+    // Scene
+    Scene("OBJViewer thumbnails", width, height, 3, 3, true),
+
+    // Default views and workers
+    views(ThumbnailScene::VIEWS),
+    threads(std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1)),
+    model_program(0U) {}
+
+
+// Setters
+
+// Set the number of rendered views per model
+void ThumbnailScene::setViews(const int &number) {
+    views = std::min(std::max(number, 1), ThumbnailScene::VIEWS);
+}
+
+// Set the number of loading worker threads
+void ThumbnailScene::setThreads(const int &number) {
+    threads = std::max(number, 1);
+}
+
+// Set the geometry pass program of the models
+void ThumbnailScene::setModelProgram(const std::size_t &program_id) {
+    model_program = program_id;
+}
+
+
+// Methods
+
+// Render the thumbnails of the models into the output directory
+bool ThumbnailScene::render(const std::vector<std::string> &path, const std::string &output_dir) {
+    // Check the window status
+    if (window == nullptr) {
+        std::cerr << "error: there is no window" << std::endl;
+        return false;
+    }
+
+    // Start the loading workers
+    const double start = glfwGetTime();
+    std::atomic<std::size_t> next(0U);
+    std::vector<std::thread> worker;
+    for (int i = 0; i < threads; i++) {
+        worker.emplace_back(&ThumbnailScene::readModels, this, std::cref(path), &next);
+    }
+
+    // Render the read models as they arrive
+    std::size_t failed = 0U;
+    for (std::size_t rendered = 0U; rendered < path.size(); rendered++) {
+        // Wait for the next read model
+        ThumbnailScene::Job job;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_ready.wait(lock, [this] () { return !queue.empty(); });
+            job = queue.front();
+            queue.pop_front();
+            queue_space.notify_one();
+        }
+
+        // Render it
+        if (!renderModel(path[job.index], job.loader, output_dir)) {
+            std::cerr << "error: could not render the thumbnails of `" << path[job.index] << "'" << std::endl;
+            failed++;
+        }
+    }
+
+    // Join the workers
+    for (std::thread &thread : worker) {
+        thread.join();
+    }
+
+    // Report the throughput
+    const double total = glfwGetTime() - start;
+    const std::size_t models = path.size() - failed;
+    std::cout << "thumbnails: " << models << " models (" << failed << " failed), " << models * static_cast<std::size_t>(views) << " images in " << total << "s, " << static_cast<double>(models) / std::max(total, 1.0E-6) << " models/s" << std::endl;
+    return failed == 0U;
+}
+
+
+// Static methods
+
+// Get the models of a directory, an OBJ file or a list file with a path per line
+std::vector<std::string> ThumbnailScene::listModels(const std::string &path) {
+    std::vector<std::string> list;
+
+    // Directory tree sorted for a stable order
+    if (ThumbnailScene::listDirectory(path, list)) {
+        std::sort(list.begin(), list.end());
+        return list;
+    }
+
+    // Single OBJ file
+    if ((path.size() > 4U) && (path.compare(path.size() - 4U, 4U, ".obj") == 0)) {
+        list.push_back(path);
+        return list;
+    }
+
+    // List file
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "error: could not open the models list `" << path << "'" << std::endl;
+        return list;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        ModelLoader::rtrim(line);
+        if (!line.empty() && (line[0U] != '#')) {
+            list.push_back(line);
+        }
+    }
+
+    return list;
+}
+
+
+// Destructor
+
+// Thumbnail scene destructor
+ThumbnailScene::~ThumbnailScene() {}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#ifndef __THUMBNAIL_SCENE_HPP_
+#define __THUMBNAIL_SCENE_HPP_
+
+#include "scene.hpp"
+
+#include "../model/loader/modelloader.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#include <deque>
+#include <vector>
+
+
+class ThumbnailScene : public Scene {
+    public:
+        // Static const attributes
+
+        /** Number of canonical views */
+        static const int VIEWS = 6;
+
+
+    private:
+        // Structs
+
+        /** Model read by a worker thread */
+        struct Job {
+            /** Model path index */
+            std::size_t index;
+
+            /** Loader with the read data, null if the format is unknown */
+            ModelLoader *loader;
+        };
+
+
+        // Attributes
+
+        /** Number of rendered views per model */
+        int views;
+
+        /** Number of loading worker threads */
+        int threads;
+
+        /** Geometry pass program of the models */
+        std::size_t model_program;
+
+
+        /** Read models queue */
+        std::deque<ThumbnailScene::Job> queue;
+
+        /** Read models queue mutex */
+        std::mutex queue_mutex;
+
+        /** Read model available condition */
+        std::condition_variable queue_ready;
+
+        /** Queue space available condition */
+        std::condition_variable queue_space;
+
+
+        // Methods
+
+        /** Read the models in a worker thread and queue them */
+        void readModels(const std::vector<std::string> &path, std::atomic<std::size_t> *const next);
+
+        /** Render the views of a read model, false if it could not be loaded */
+        bool renderModel(const std::string &path, ModelLoader *const loader, const std::string &output_dir);
+
+
+        // Static const attributes
+
+        /** Canonical views directions from the model */
+        static const glm::vec3 VIEW_DIRECTION[ThumbnailScene::VIEWS];
+
+        /** Canonical views names */
+        static const char *const VIEW_NAME[ThumbnailScene::VIEWS];
+
+
+        // Static methods
+
+        /** List the OBJ files of a directory tree */
+        static bool listDirectory(const std::string &path, std::vector<std::string> &list);
+
+        /** Get the output base name of a model path */
+        static std::string getOutputName(const std::string &path);
+
+
+    public:
+        // Constructor
+
+        /** Thumbnail scene constructor */
+        ThumbnailScene(const int &width = 256, const int &height = 256);
+
+
+        // Setters
+
+        /** Set the number of rendered views per model */
+        void setViews(const int &number);
+
+        /** Set the number of loading worker threads */
+        void setThreads(const int &number);
+
+        /** Set the geometry pass program of the models */
+        void setModelProgram(const std::size_t &program_id);
+
+
+        // Methods
+
+        /** Render the thumbnails of the models into the output directory */
+        bool render(const std::vector<std::string> &path, const std::string &output_dir);
+
+
+        // Static methods
+
+        /** Get the models of a directory, an OBJ file or a list file with a path per line */
+        static std::vector<std::string> listModels(const std::string &path);
+
+
+        // Destructor
+
+        /** Thumbnail scene destructor */
+        virtual ~ThumbnailScene();
+};
+
+#endif // __THUMBNAIL_SCENE_HPP_
\ No newline at end of file